@@ -193,7 +193,7 @@ DB::Status BachopdDB::Scan(const std::string &table, const std::string &key, int
     if (result.size() >= static_cast<size_t>(len)) {
       break;
     }
-    auto &ans = result.emplace_back();
+    auto &ans = AppendRow(result);
     if (fields != nullptr) {
       DeserializeRowFilter(ans, data, *fields);
     } else {
@@ -249,7 +249,7 @@ DB::Status BachopdDB::Filter(const std::string &table, const std::vector<DB::Fie
     }
   }
   for (auto &t : tuples) {
-    auto &ans = result.emplace_back();
+    auto &ans = AppendRow(result);
     if (fields != nullptr) {
       DeserializeRowFilter(ans, t, *fields);
     } else {
@@ -0,0 +1,171 @@
+//
+//  generator_bench.cc
+//  YCSB-cpp
+//
+//  Measures the sampling rate of the key choosers: the Gray and the
+//  rejection-inversion zipfian samplers, shared by all threads or cloned per
+//  thread, over a fixed and over a growing number of items, and zipfian keys
+//  drawn below the inserted bound by rejection and by rescaling.
+//
+//  Usage: generator_bench [threads] [samples per thread]
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/counter_generator.h"
+#include "core/scrambled_zipfian_generator.h"
+#include "core/skewed_latest_generator.h"
+#include "core/uniform_generator.h"
+#include "core/zipfian_generator.h"
+
+using ycsbc::CounterGenerator;
+using ycsbc::Generator;
+using ycsbc::ScrambledZipfianGenerator;
+using ycsbc::SkewedLatestGenerator;
+using ycsbc::UniformGenerator;
+using ycsbc::ZipfianGenerator;
+
+namespace {
+
+constexpr uint64_t kItems = 100000000;
+
+// Runs threads that each draw samples from the generator, or from a clone of it if per_thread
+// is set, and returns millions of samples per second. grow is called every 1024 samples.
+double Run(Generator<uint64_t> &shared, bool per_thread, int threads, uint64_t samples,
+           const std::function<void()> &grow = nullptr) {
+  std::atomic<uint64_t> sink(0);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&]() {
+      std::unique_ptr<Generator<uint64_t>> clone(per_thread ? shared.Clone() : nullptr);
+      Generator<uint64_t> &g = clone ? *clone : shared;
+      uint64_t sum = 0;
+      for (uint64_t i = 0; i < samples; i++) {
+        if (grow && i % 1024 == 0) {
+          grow();
+        }
+        sum += g.Next();
+      }
+      sink += sum;
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return threads * samples / secs / 1e6;
+}
+
+template <typename F>
+double Setup(F make) {
+  auto start = std::chrono::steady_clock::now();
+  make();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// a negative rate is not measured
+void Report(const std::string &name, double setup_ms, double shared, double cloned) {
+  std::cout << std::left << std::setw(28) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(12) << setup_ms << std::setw(12);
+  if (shared < 0) {
+    std::cout << "-";
+  } else {
+    std::cout << shared;
+  }
+  std::cout << std::setw(12) << cloned << std::endl;
+}
+
+// A scrambled zipfian generator sampled below a bound by the given function.
+class BoundedScrambled : public Generator<uint64_t> {
+ public:
+  using Sample = std::function<uint64_t(ScrambledZipfianGenerator &)>;
+  BoundedScrambled(uint64_t items, ZipfianGenerator::Sampler sampler, Sample sample) :
+      generator_(0, items - 1, ZipfianGenerator::kZipfianConst, sampler), sample_(sample) {}
+  uint64_t Next() { return last_ = sample_(generator_); }
+  uint64_t Last() { return last_; }
+  Generator<uint64_t> *Clone() const { return new BoundedScrambled(*this); }
+ private:
+  ScrambledZipfianGenerator generator_;
+  Sample sample_;
+  uint64_t last_ = 0;
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int threads = argc > 1 ? std::stoi(argv[1]) : 4;
+  uint64_t samples = argc > 2 ? std::stoull(argv[2]) : 10000000;
+
+  std::cout << threads << " threads, " << samples << " samples per thread, " << kItems
+            << " items" << std::endl;
+  std::cout << std::left << std::setw(28) << "generator" << std::right << std::setw(12)
+            << "setup ms" << std::setw(12) << "shared M/s" << std::setw(12) << "clone M/s"
+            << std::endl;
+
+  const ZipfianGenerator::Sampler samplers[] = {ZipfianGenerator::Sampler::kGray,
+                                                ZipfianGenerator::Sampler::kRejection};
+  const char *names[] = {"gray", "rejection"};
+
+  {
+    std::unique_ptr<UniformGenerator> g;
+    double setup = Setup([&]() { g.reset(new UniformGenerator(0, kItems - 1)); });
+    Report("uniform", setup, Run(*g, false, threads, samples), Run(*g, true, threads, samples));
+  }
+
+  for (int s = 0; s < 2; s++) {
+    std::unique_ptr<ZipfianGenerator> g;
+    double setup = Setup([&]() {
+      g.reset(new ZipfianGenerator(0, kItems - 1, ZipfianGenerator::kZipfianConst, samplers[s]));
+    });
+    Report(std::string("zipfian ") + names[s], setup, Run(*g, false, threads, samples),
+           Run(*g, true, threads, samples));
+  }
+
+  for (int s = 0; s < 2; s++) {
+    std::unique_ptr<ScrambledZipfianGenerator> g;
+    double setup = Setup([&]() {
+      g.reset(new ScrambledZipfianGenerator(0, kItems - 1, ZipfianGenerator::kZipfianConst,
+                                            samplers[s]));
+    });
+    Report(std::string("scrambled ") + names[s], setup, Run(*g, false, threads, samples),
+           Run(*g, true, threads, samples));
+  }
+
+  // the number of items grows by one every 1024 samples of each thread, as with inserts; a
+  // growing zipfian generator is not shared
+  for (int s = 0; s < 2; s++) {
+    CounterGenerator counter(kItems);
+    std::unique_ptr<SkewedLatestGenerator> g;
+    double setup = Setup([&]() { g.reset(new SkewedLatestGenerator(counter, samplers[s])); });
+    auto grow = [&counter]() { counter.Next(); };
+    Report(std::string("latest ") + names[s], setup, -1, Run(*g, true, threads, samples, grow));
+  }
+
+  // keys of a key space of twice the inserted keys, as for an insert-heavy run
+  for (int s = 0; s < 2; s++) {
+    const uint64_t max = kItems - 1;
+    BoundedScrambled rejected(2 * kItems, samplers[s], [max](ScrambledZipfianGenerator &g) {
+      uint64_t key;
+      do {
+        key = g.Next();
+      } while (key > max);
+      return key;
+    });
+    BoundedScrambled rescaled(2 * kItems, samplers[s], [max](ScrambledZipfianGenerator &g) {
+      return g.Next(max);
+    });
+    Report(std::string("bounded reject ") + names[s], 0, -1, Run(rejected, true, threads, samples));
+    Report(std::string("bounded rescale ") + names[s], 0, -1, Run(rescaled, true, threads, samples));
+  }
+  return 0;
+}
@@ -9,36 +9,71 @@
 #ifndef YCSB_C_CLIENT_H_
 #define YCSB_C_CLIENT_H_
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "db.h"
 #include "core_workload.h"
+#include "measurements.h"
+#include "utils/coroutine.h"
+#include "utils/coroutine_pacing.h"
 #include "utils/countdown_latch.h"
+#include "utils/op_budget.h"
 #include "utils/rate_limit.h"
 #include "utils/utils.h"
 
 namespace ycsbc {
 
-inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_ops, bool is_loading, bool is_htap, bool is_ap,
-                        bool init_db, bool cleanup_db, utils::CountDownLatch *latch, utils::RateLimiter *rlim, bool *ap_done, bool *time_limit) {
+///
+/// Synchronizes the client threads of a phase with the driver. Threads count
+/// down ready after DB::Init, start issuing operations once start is counted
+/// down and count down finished before DB::Cleanup, so that neither Init nor
+/// Cleanup falls into the measured window.
+///
+struct ClientSync {
+  explicit ClientSync(int num_threads) : ready(num_threads), start(1), finished(num_threads) {}
+
+  utils::CountDownLatch ready;
+  utils::CountDownLatch start;
+  utils::CountDownLatch finished;
+};
+
+inline int64_t ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, utils::OpBudget *budget, bool is_loading, bool is_htap,
+                        bool is_ap, bool init_db, bool cleanup_db, ClientSync *sync, utils::RateLimiter *rlim,
+                        bool open_loop, bool *ap_done) {
 
   try {
     if (init_db) {
       db->Init();
     }
+    sync->ready.CountDown();
+    sync->start.Await();
 
-    int ops = 0;
+    const int slot = budget->Join();
+    int64_t ops = 0;
+    int64_t remaining = 0;
     auto start_time = std::chrono::high_resolution_clock::now();;
-    for (int i = 0; i < num_ops; ++i) {
-      if (rlim) {
-        rlim->Consume(1);
+    while (remaining > 0 || (remaining = budget->Claim()) > 0) {
+      if (budget->Expired()) {
+        break;
+      }
+      remaining--;
+      if (rlim && open_loop) {
+        Measurements::SetIntendedStartTime(rlim->NextIntendedStart());
+      } else {
+        // operation types paced by the workload set their own intended start
+        Measurements::SetIntendedStartTime(0);
+        if (rlim) {
+          rlim->Consume(1);
+        }
       }
       if (is_htap) {
         if (is_ap) {
-          if(time_limit && *time_limit) {
-            break;
-          }
           wl->DoAP(*db);
           auto now_time = std::chrono::high_resolution_clock::now();
           std::cout<< "AP operation done at "<< 
@@ -58,13 +93,105 @@ inline int ClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, const int num_op
         }
       }
       ops++;
+      budget->Complete(slot, ops);
     }
+    budget->Leave();
+
+    Measurements::SetIntendedStartTime(0);
+    sync->finished.CountDown();
+
+    if (cleanup_db) {
+      db->Cleanup();
+    }
+
+    return ops;
+  } catch (const utils::Exception &e) {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    exit(1);
+  }
+}
+
+inline utils::Task<void> ClientCoroutine(ycsbc::DB *db, ycsbc::CoreWorkload *wl, utils::OpBudget *budget,
+                                         bool is_loading, utils::RateLimiter *rlim, bool open_loop, int slot,
+                                         int64_t *remaining, int64_t *ops, utils::CoroutinePacing *pacing) {
+  while (*remaining > 0 || (*remaining = budget->Claim()) > 0) {
+    if (budget->Expired()) {
+      break;
+    }
+    --*remaining;
+    uint64_t intended_start = 0;
+    if (rlim) {
+      // wait for the slot or tokens without blocking the other coroutines of the thread
+      uint64_t due = open_loop ? rlim->ReserveNextIntendedStart() : rlim->Reserve(1);
+      co_await pacing->Until(due, rlim->SpinNanos());
+      rlim->Released(due);
+      if (open_loop) {
+        intended_start = due;
+      }
+    }
+    // operation types paced by the workload set their own intended start
+    Measurements::SetIntendedStartTime(intended_start);
+    if (is_loading) {
+      co_await wl->DoInsertAsync(*db);
+    } else {
+      co_await wl->DoTransactionAsync(*db);
+    }
+    ++*ops;
+    budget->Complete(slot, *ops);
+  }
+}
+
+///
+/// Client thread that keeps up to `inflight` operations outstanding, each one
+/// driven by its own coroutine. With a DB that has no native asynchronous
+/// operations every operation completes immediately and this degenerates to
+/// one-op-at-a-time.
+///
+inline int64_t CoroutineClientThread(ycsbc::DB *db, ycsbc::CoreWorkload *wl, utils::OpBudget *budget, bool is_loading,
+                                 bool init_db, bool cleanup_db, ClientSync *sync,
+                                 utils::RateLimiter *rlim, bool open_loop, int inflight) {
+  try {
+    if (init_db) {
+      db->Init();
+    }
+    sync->ready.CountDown();
+    sync->start.Await();
+
+    const int slot = budget->Join();
+    int64_t remaining = 0;
+    int64_t ops = 0;
+    std::vector<utils::Task<void>> clients;
+    utils::CoroutinePacing pacing;
+    CoreWorkload::SetThreadPacing(&pacing);
+    for (int i = 0; i < inflight; ++i) {
+      clients.push_back(ClientCoroutine(db, wl, budget, is_loading, rlim, open_loop, slot, &remaining, &ops,
+                                        &pacing));
+      clients.back().Start();
+    }
+    auto running = [&clients]() {
+      return std::count_if(clients.begin(), clients.end(), [](const utils::Task<void> &c) { return !c.Done(); });
+    };
+    while (running() > 0) {
+      db->Poll();
+      pacing.ResumeDue();
+      // sleep only if no operation is outstanding
+      if (pacing.Waiting() > 0 && static_cast<ptrdiff_t>(pacing.Waiting()) == running()) {
+        pacing.SleepUntilDue();
+      }
+    }
+    for (auto &client : clients) {
+      client.Result();
+    }
+    CoreWorkload::SetThreadPacing(nullptr);
+    budget->Leave();
+
+    Measurements::SetIntendedStartTime(0);
+    sync->finished.CountDown();
 
     if (cleanup_db) {
       db->Cleanup();
     }
 
-    latch->CountDown();
     return ops;
   } catch (const utils::Exception &e) {
     std::cerr << "Caught exception: " << e.what() << std::endl;
@@ -14,11 +14,16 @@
 #include "const_generator.h"
 #include "core_workload.h"
 #include "random_byte_generator.h"
+#include "measurements.h"
 #include "utils/utils.h"
 
 #include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
 #include <random>
 #include <string>
+#include <string_view>
 #include <iostream>
 
 using ycsbc::CoreWorkload;
@@ -32,15 +37,23 @@ const char *ycsbc::kOperationString[ycsbc::MAXOPTYPE] = {
   "READMODIFYWRITE",
   "DELETE",
   "FILTER",
+  "MULTIREAD",
   "INSERT-FAILED",
   "READ-FAILED",
   "UPDATE-FAILED",
   "SCAN-FAILED",
   "READMODIFYWRITE-FAILED",
   "DELETE-FAILED",
-  "FILTER-FAILED"
+  "FILTER-FAILED",
+  "MULTIREAD-FAILED"
 };
 
+thread_local ycsbc::TraceReplay *CoreWorkload::thread_replay_ = nullptr;
+thread_local ycsbc::utils::CoroutinePacing *CoreWorkload::thread_pacing_ = nullptr;
+thread_local CoreWorkload::OpContext CoreWorkload::thread_ctx_;
+thread_local CoreWorkload::ThreadGenerators CoreWorkload::thread_generators_;
+std::atomic<uint64_t> CoreWorkload::next_epoch_(1);
+
 const string CoreWorkload::TABLENAME_PROPERTY = "table";
 const string CoreWorkload::TABLENAME_DEFAULT = "usertable";
 
@@ -80,6 +93,12 @@ const string CoreWorkload::SCAN_PROPORTION_DEFAULT = "0.0";
 const string CoreWorkload::READMODIFYWRITE_PROPORTION_PROPERTY = "readmodifywriteproportion";
 const string CoreWorkload::READMODIFYWRITE_PROPORTION_DEFAULT = "0.0";
 
+const string CoreWorkload::MULTIREAD_PROPORTION_PROPERTY = "multireadproportion";
+const string CoreWorkload::MULTIREAD_PROPORTION_DEFAULT = "0.0";
+
+const string CoreWorkload::MULTIREAD_BATCH_SIZE_PROPERTY = "multireadbatchsize";
+const string CoreWorkload::MULTIREAD_BATCH_SIZE_DEFAULT = "16";
+
 const string CoreWorkload::FILTER_PROPORTION_PROPERTY = "filterproportion";
 const string CoreWorkload::FILTER_PROPORTION_DEFAULT = "0.0";
 
@@ -118,6 +137,17 @@ const std::string CoreWorkload::KEY_LENGTH_PROPERTY = "keylength";
 const std::string CoreWorkload::KEY_LENGTH_DEFAULT = "16";
 
 const std::string CoreWorkload::ZIPFIAN_CONST_PROPERTY = "zipfian_const";
+const std::string CoreWorkload::ZIPFIAN_SAMPLER_PROPERTY = "zipfian_sampler";
+const std::string CoreWorkload::ZIPFIAN_SAMPLER_DEFAULT = "gray";
+
+const std::string CoreWorkload::ZIPFIAN_RESCALE_PROPERTY = "zipfian_rescale";
+const std::string CoreWorkload::ZIPFIAN_RESCALE_DEFAULT = "false";
+
+const std::string CoreWorkload::VALUE_POOL_SIZE_PROPERTY = "valuepoolsize";
+const std::string CoreWorkload::VALUE_POOL_SIZE_DEFAULT = "0";
+
+const std::string CoreWorkload::VALUE_COMPRESSIBILITY_PROPERTY = "valuecompressibility";
+const std::string CoreWorkload::VALUE_COMPRESSIBILITY_DEFAULT = "1";
 
 namespace ycsbc {
 
@@ -127,7 +157,24 @@ void CoreWorkload::Init(const utils::Properties &p) {
   field_count_ = std::stoi(p.GetProperty(FIELD_COUNT_PROPERTY, FIELD_COUNT_DEFAULT));
   numdistinct_ = std::stoi(p.GetProperty(DISTINCT_VALUE_NUM_PROPERTY, DISTINCT_VALUE_NUM_DEFAULT));
   field_prefix_ = p.GetProperty(FIELD_NAME_PREFIX, FIELD_NAME_PREFIX_DEFAULT);
+  field_names_.clear();
+  for (int i = 0; i < field_count_; ++i) {
+    field_names_.push_back(field_prefix_ + std::to_string(i));
+  }
   field_len_generator_ = GetFieldLenGenerator(p);
+  value_compressibility_ = std::stod(p.GetProperty(VALUE_COMPRESSIBILITY_PROPERTY,
+                                                   VALUE_COMPRESSIBILITY_DEFAULT));
+  if (value_compressibility_ < 1) {
+    throw utils::Exception("valuecompressibility must be at least 1");
+  }
+  // replayed writes always copy from the pool, so there is a small one without pool mode
+  uint64_t value_pool_size = std::stoull(p.GetProperty(VALUE_POOL_SIZE_PROPERTY, VALUE_POOL_SIZE_DEFAULT));
+  use_value_pool_ = value_pool_size > 0;
+  value_pool_.resize(use_value_pool_ ? value_pool_size : 1 << 20);
+  // the pool is made of short compressible pieces, so slices at any offset compress alike
+  for (size_t off = 0; off < value_pool_.size(); off += 100) {
+    FillValueBytes(value_pool_.data() + off, std::min<size_t>(100, value_pool_.size() - off));
+  }
     if(numdistinct_ > 0){
     distinct_value_generator_ = new DistinctValueGenerator();
     string distinct_value_dist = p.GetProperty(DISTINCT_VALUE_DISTRIBUTION_PROPERTY,
@@ -163,15 +210,26 @@ void CoreWorkload::Init(const utils::Properties &p) {
       READMODIFYWRITE_PROPORTION_PROPERTY, READMODIFYWRITE_PROPORTION_DEFAULT));
   double filter_proportion = std::stod(p.GetProperty(FILTER_PROPORTION_PROPERTY,
                                                      FILTER_PROPORTION_DEFAULT));
+  double multiread_proportion = std::stod(p.GetProperty(MULTIREAD_PROPORTION_PROPERTY,
+                                                        MULTIREAD_PROPORTION_DEFAULT));
+  multiread_batch_size_ = std::stoi(p.GetProperty(MULTIREAD_BATCH_SIZE_PROPERTY,
+                                                  MULTIREAD_BATCH_SIZE_DEFAULT));
+  if (multiread_batch_size_ <= 0) {
+    throw utils::Exception("Multi-read batch size must be positive");
+  }
 
-  record_count_ = std::stoi(p.GetProperty(RECORD_COUNT_PROPERTY));
+  record_count_ = std::stoull(p.GetProperty(RECORD_COUNT_PROPERTY));
   std::string request_dist = p.GetProperty(REQUEST_DISTRIBUTION_PROPERTY,
                                            REQUEST_DISTRIBUTION_DEFAULT);
   int min_scan_len = std::stoi(p.GetProperty(MIN_SCAN_LENGTH_PROPERTY, MIN_SCAN_LENGTH_DEFAULT));
   int max_scan_len = std::stoi(p.GetProperty(MAX_SCAN_LENGTH_PROPERTY, MAX_SCAN_LENGTH_DEFAULT));
   std::string scan_len_dist = p.GetProperty(SCAN_LENGTH_DISTRIBUTION_PROPERTY,
                                             SCAN_LENGTH_DISTRIBUTION_DEFAULT);
-  int insert_start = std::stoi(p.GetProperty(INSERT_START_PROPERTY, INSERT_START_DEFAULT));
+  insert_start_ = std::stoull(p.GetProperty(INSERT_START_PROPERTY, INSERT_START_DEFAULT));
+  bulk_batch_size_ = std::stoi(p.GetProperty("load.batch", "1000"));
+  if (bulk_batch_size_ <= 0) {
+    throw utils::Exception("load.batch must be positive");
+  }
 
   zero_padding_ = std::stoi(p.GetProperty(ZERO_PADDING_PROPERTY, ZERO_PADDING_DEFAULT));
 
@@ -205,9 +263,43 @@ void CoreWorkload::Init(const utils::Properties &p) {
   if (filter_proportion > 0) {
     op_chooser_.AddValue(FILTER, filter_proportion);
   }
+  if (multiread_proportion > 0) {
+    op_chooser_.AddValue(MULTIREAD, multiread_proportion);
+  }
 
-  insert_key_sequence_ = new CounterGenerator(insert_start);
-  transaction_insert_key_sequence_ = new AcknowledgedCounterGenerator(record_count_);
+  // limit.<op>.ops paces an operation type independently of the others
+  const int64_t spin_us = std::stoll(p.GetProperty("limit.spin_us", "100"));
+  op_open_loop_ = utils::StrToBool(p.GetProperty("limit.openloop", "false"));
+  for (Operation op : {READ, UPDATE, INSERT, SCAN, READMODIFYWRITE, FILTER, MULTIREAD}) {
+    string name = kOperationString[op];
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    op_limit_[op] = std::stoll(p.GetProperty("limit." + name + ".ops", "0"));
+    if (op_limit_[op] > 0) {
+      op_limiter_[op] = new utils::RateLimiter(op_limit_[op], op_limit_[op], spin_us * 1000);
+    }
+  }
+  // the types without a limit, in their proportions, fill in for limited types that are not due
+  has_unlimited_ops_ = false;
+  for (const auto &[op, proportion] : {std::pair{READ, read_proportion},
+                                       std::pair{UPDATE, update_proportion},
+                                       std::pair{INSERT, insert_proportion},
+                                       std::pair{SCAN, scan_proportion},
+                                       std::pair{READMODIFYWRITE, readmodifywrite_proportion},
+                                       std::pair{FILTER, filter_proportion},
+                                       std::pair{MULTIREAD, multiread_proportion}}) {
+    if (proportion > 0 && op_limiter_[op] == nullptr) {
+      unlimited_op_chooser_.AddValue(op, proportion);
+      has_unlimited_ops_ = true;
+    }
+  }
+
+  insert_key_sequence_ = new CounterGenerator(insert_start_);
+  if (!transaction_insert_key_sequence_) {
+    transaction_insert_key_sequence_ = std::make_shared<AcknowledgedCounterGenerator>(record_count_);
+  }
+
+  zipfian_rescale_ = utils::StrToBool(p.GetProperty(ZIPFIAN_RESCALE_PROPERTY,
+                                                    ZIPFIAN_RESCALE_DEFAULT));
 
   if (request_dist == "uniform") {
     key_chooser_ = new UniformGenerator(0, record_count_ - 1);
@@ -217,17 +309,22 @@ void CoreWorkload::Init(const utils::Properties &p) {
     // So we construct the scrambled zipfian generator with a keyspace
     // that is larger than what exists at the beginning of the test.
     // If the generator picks a key that is not inserted yet, we just ignore it
-    // and pick another key.
-    int op_count = std::stoi(p.GetProperty(OPERATION_COUNT_PROPERTY));
-    int new_keys = (int)(op_count * insert_proportion * 2); // a fudge factor
+    // and pick another key, or rescale it into the inserted range if
+    // zipfian_rescale is set (see ScrambledZipfianGenerator::Next(max)).
+    int64_t op_count = std::stoll(p.GetProperty(OPERATION_COUNT_PROPERTY));
+    uint64_t new_keys = std::max<int64_t>(op_count, 0) * insert_proportion * 2; // a fudge factor
     if (p.ContainsKey(ZIPFIAN_CONST_PROPERTY)) {
       double zipfian_const = std::stod(p.GetProperty(ZIPFIAN_CONST_PROPERTY));
-      key_chooser_ = new ScrambledZipfianGenerator(0, record_count_ + new_keys - 1, zipfian_const);
+      key_chooser_ = new ScrambledZipfianGenerator(0, record_count_ + new_keys - 1, zipfian_const,
+                                                   GetZipfianSampler(p));
     } else {
-      key_chooser_ = new ScrambledZipfianGenerator(record_count_ + new_keys);
+      key_chooser_ = new ScrambledZipfianGenerator(0, record_count_ + new_keys - 1,
+                                                   ZipfianGenerator::kZipfianConst,
+                                                   GetZipfianSampler(p));
     }
   } else if (request_dist == "latest") {
-    key_chooser_ = new SkewedLatestGenerator(*transaction_insert_key_sequence_);
+    key_chooser_ = new SkewedLatestGenerator(*transaction_insert_key_sequence_,
+                                             GetZipfianSampler(p));
   } else {
     throw utils::Exception("Unknown request distribution: " + request_dist);
   }
@@ -236,17 +333,64 @@ void CoreWorkload::Init(const utils::Properties &p) {
   if (key_len_ <= 4) {
     throw utils::Exception("Key length must be greater than 4");
   }
-  key_len_ = key_len_ - 4; 
+  key_len_ = key_len_ - 4;
+  // keys keep the first key_len_ digits of the key number (or of its hash), so large key
+  // spaces map several records to one key
+  const bool keys_collide = ordered_inserts_ ?
+      std::to_string(insert_start_ + record_count_ - 1).size() > static_cast<size_t>(key_len_) :
+      record_count_ / 2.0 / std::pow(10.0, key_len_) > 0.001;
+  if (keys_collide) {
+    std::cerr << "Warning: keylength " << key_len_ + 4 << " maps some of the " << record_count_
+              << " records to the same key" << std::endl;
+  }
 
   field_chooser_ = new UniformGenerator(0, field_count_ - 1);
 
   if (scan_len_dist == "uniform") {
     scan_len_chooser_ = new UniformGenerator(min_scan_len, max_scan_len);
   } else if (scan_len_dist == "zipfian") {
-    scan_len_chooser_ = new ZipfianGenerator(min_scan_len, max_scan_len);
+    scan_len_chooser_ = new ZipfianGenerator(min_scan_len, max_scan_len,
+                                             ZipfianGenerator::kZipfianConst, GetZipfianSampler(p));
   } else {
     throw utils::Exception("Distribution not allowed for scan length: " + scan_len_dist);
   }
+
+  // threads clone the generators again on their next operation
+  epoch_ = next_epoch_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CoreWorkload::CloneGenerators(ThreadGenerators &generators) {
+  generators.clones.clear();
+  auto clone = [&generators](Generator<uint64_t> *shared) {
+    Generator<uint64_t> *g = shared->Clone();
+    if (g == nullptr) {
+      return shared;
+    }
+    generators.clones.emplace_back(g);
+    return g;
+  };
+  generators.key_chooser = clone(key_chooser_);
+  generators.scrambled_key_chooser = zipfian_rescale_ ?
+      dynamic_cast<ScrambledZipfianGenerator *>(generators.key_chooser) : nullptr;
+  generators.field_chooser = clone(field_chooser_);
+  generators.scan_len_chooser = clone(scan_len_chooser_);
+  generators.field_len_generator = clone(field_len_generator_);
+  generators.op_chooser_clone.reset(op_chooser_.Clone());
+  generators.op_chooser = generators.op_chooser_clone.get();
+  generators.unlimited_op_chooser_clone.reset(has_unlimited_ops_ ? unlimited_op_chooser_.Clone() : nullptr);
+  generators.unlimited_op_chooser = generators.unlimited_op_chooser_clone.get();
+  generators.epoch = epoch_;
+}
+
+ZipfianGenerator::Sampler CoreWorkload::GetZipfianSampler(const utils::Properties &p) {
+  string sampler = p.GetProperty(ZIPFIAN_SAMPLER_PROPERTY, ZIPFIAN_SAMPLER_DEFAULT);
+  if (sampler == "gray") {
+    return ZipfianGenerator::Sampler::kGray;
+  } else if (sampler == "rejection") {
+    return ZipfianGenerator::Sampler::kRejection;
+  } else {
+    throw utils::Exception("Unknown zipfian sampler: " + sampler);
+  }
 }
 
 ycsbc::Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator(
@@ -259,75 +403,359 @@ ycsbc::Generator<uint64_t> *CoreWorkload::GetFieldLenGenerator(
   } else if(field_len_dist == "uniform") {
     return new UniformGenerator(1, field_len);
   } else if(field_len_dist == "zipfian") {
-    return new ZipfianGenerator(1, field_len);
+    return new ZipfianGenerator(1, field_len, ZipfianGenerator::kZipfianConst,
+                                GetZipfianSampler(p));
   } else {
     throw utils::Exception("Unknown field length distribution: " + field_len_dist);
   }
 }
 
-std::string CoreWorkload::BuildKeyName(uint64_t key_num) {
+namespace {
+
+constexpr char kDigitPairs[] =
+    "00010203040506070809" "10111213141516171819" "20212223242526272829" "30313233343536373839"
+    "40414243444546474849" "50515253545556575859" "60616263646566676869" "70717273747576777879"
+    "80818283848586878889" "90919293949596979899";
+
+// Writes the decimal digits of v so that they end right before end, two at a time.
+// Returns the position of the first digit.
+inline char *FormatDecimal(uint64_t v, char *end) {
+  while (v >= 100) {
+    end -= 2;
+    std::memcpy(end, &kDigitPairs[(v % 100) * 2], 2);
+    v /= 100;
+  }
+  if (v >= 10) {
+    end -= 2;
+    std::memcpy(end, &kDigitPairs[v * 2], 2);
+  } else {
+    *--end = static_cast<char>('0' + v);
+  }
+  return end;
+}
+
+} // namespace
+
+// The key is "user", the digits of the key number repeated to fill key_len_ (the last copy
+// keeping its trailing digits) and zero padding. It is written in place into key, so a
+// reused buffer formats keys without allocating.
+void CoreWorkload::BuildKeyName(uint64_t key_num, std::string &key) {
   if (!ordered_inserts_) {
     key_num = utils::Hash(key_num);
   }
-  std::string prekey = "user";
-  std::string value = std::to_string(key_num);
-  int cnt = key_len_ / value.size();
-  for (int i = 0; i < cnt; ++i) {
-    prekey.append(value);
+  char buf[20];
+  const char *digits = FormatDecimal(key_num, buf + sizeof(buf));
+  const size_t n = buf + sizeof(buf) - digits;
+  const size_t len = key_len_;
+  const size_t fill = zero_padding_ > static_cast<int>(n) ? zero_padding_ - n : 0;
+  key.resize(4 + len + fill);
+  char *out = key.data();
+  std::memcpy(out, "user", 4);
+  out += 4;
+  if (n >= len) {
+    // hashed key numbers have 19 or 20 digits, more than the default key length takes
+    std::memcpy(out, digits + n - len, len);
+    out += len;
+  } else {
+    for (size_t i = 0; i < len / n; ++i) {
+      std::memcpy(out, digits, n);
+      out += n;
+    }
+    const size_t rest = len % n;
+    std::memcpy(out, digits + n - rest, rest);
+    out += rest;
   }
-  prekey.append(value, value.size() + cnt * value.size() - key_len_);
-  int fill = std::max(0, zero_padding_ - static_cast<int>(value.size()));
-  return prekey.append(fill, '0');
+  std::memset(out, '0', fill);
 }
 
+// Replaces values with a value for every field. Fields already in values are overwritten
+// in place, so a reused vector keeps the capacity of its strings.
 void CoreWorkload::BuildValues(std::vector<ycsbc::DB::Field> &values) {
+  values.resize(field_count_);
   for (int i = 0; i < field_count_; ++i) {
-    values.push_back(DB::Field());
-    ycsbc::DB::Field &field = values.back();
-    field.name.append(field_prefix_).append(std::to_string(i));
-    uint64_t len = field_len_generator_->Next();
-    field.value.reserve(len);
+    ycsbc::DB::Field &field = values[i];
+    field.name = field_names_[i];
+    field.value.clear();
+    uint64_t len = Generators().field_len_generator->Next();
     if(numdistinct_){
+      field.value.reserve(len);
       distinct_value_generator_->Next(field.value);
     }else{
-      RandomByteGenerator byte_generator;
-      std::generate_n(std::back_inserter(field.value), len, [&]() { return byte_generator.Next(); } );         
+      AppendValueBytes(field.value, len, use_value_pool_);
     }
   }
 }
 
-void CoreWorkload::BuildSingleValue(std::vector<ycsbc::DB::Field> &values) {
-  values.push_back(DB::Field());
+// Replaces values with a value for one random field.
+uint64_t CoreWorkload::BuildSingleValue(std::vector<ycsbc::DB::Field> &values) {
+  values.resize(1);
   ycsbc::DB::Field &field = values.back();
-  field.name.append(NextFieldName());
-  uint64_t len = field_len_generator_->Next();
-  field.value.reserve(len);
-  RandomByteGenerator byte_generator;
-  std::generate_n(std::back_inserter(field.value), len, [&]() { return byte_generator.Next(); } );
+  uint64_t field_num = Generators().field_chooser->Next();
+  field.name = field_names_[field_num];
+  field.value.clear();
+  AppendValueBytes(field.value, Generators().field_len_generator->Next(), use_value_pool_);
+  return field_num;
+}
+
+// Appends len random bytes, copied from the value pool at random offsets or generated afresh.
+void CoreWorkload::AppendValueBytes(std::string &value, uint64_t len, bool from_pool) {
+  if (!from_pool) {
+    size_t old_size = value.size();
+    value.resize(old_size + len);
+    FillValueBytes(value.data() + old_size, len);
+    return;
+  }
+  value.reserve(value.size() + len);
+  while (len > 0) {
+    size_t offset = utils::ThreadLocalRandomInt() % value_pool_.size();
+    size_t n = std::min<size_t>(len, value_pool_.size() - offset);
+    value.append(value_pool_, offset, n);
+    len -= n;
+  }
+}
+
+// Fills len bytes whose compression ratio is about value_compressibility_: a fragment of
+// len / ratio random bytes is repeated to the full length.
+void CoreWorkload::FillValueBytes(char *out, size_t len) {
+  if (value_compressibility_ <= 1 || len == 0) {
+    RandomByteGenerator::Fill(out, len);
+    return;
+  }
+  size_t fresh = std::clamp<size_t>(static_cast<size_t>(len / value_compressibility_), 1, len);
+  RandomByteGenerator::Fill(out, fresh);
+  for (size_t off = fresh; off < len; off += fresh) {
+    std::memcpy(out + off, out, std::min(fresh, len - off));
+  }
 }
 
 uint64_t CoreWorkload::NextTransactionKeyNum() {
+  ThreadGenerators &generators = Generators();
+  const uint64_t last = transaction_insert_key_sequence_->Last();
+  if (generators.scrambled_key_chooser != nullptr) {
+    return generators.scrambled_key_chooser->Next(last);
+  }
+  // keys not inserted yet are drawn again, the uniform and latest choosers stay within
+  // the inserted keys
   uint64_t key_num;
   do {
-    key_num = key_chooser_->Next();
-  } while (key_num > transaction_insert_key_sequence_->Last());
+    key_num = generators.key_chooser->Next();
+  } while (key_num > last);
   return key_num;
 }
 
+std::string CoreWorkload::FieldName(uint64_t field_num) {
+  if (field_num < field_names_.size()) {
+    return field_names_[field_num];
+  }
+  // replayed traces may name fields beyond fieldcount
+  return std::string(field_prefix_).append(std::to_string(field_num));
+}
+
 std::string CoreWorkload::NextFieldName() {
-  return std::string(field_prefix_).append(std::to_string(field_chooser_->Next()));
+  return FieldName(Generators().field_chooser->Next());
+}
+
+uint64_t CoreWorkload::NextField(std::vector<std::string> &fields) {
+  uint64_t field_num = Generators().field_chooser->Next();
+  fields.push_back(FieldName(field_num));
+  return field_num;
+}
+
+uint64_t CoreWorkload::ValueBytes(const std::vector<DB::Field> &values) {
+  uint64_t bytes = 0;
+  for (const DB::Field &field : values) {
+    bytes += field.value.size();
+  }
+  return bytes;
+}
+
+void CoreWorkload::AppendTrace(TraceOp *ops, size_t n) {
+  uint64_t start = Measurements::GetIntendedStartTime();
+  if (start == 0) {
+    start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+  trace_->Append(ops, n, start);
+}
+
+void CoreWorkload::TraceMultiRead(const std::vector<uint64_t> &key_nums, uint64_t field) {
+  if (trace_ == nullptr) {
+    return;
+  }
+  std::vector<TraceOp> ops;
+  for (uint64_t key_num : key_nums) {
+    ops.push_back({0, key_num, 0, static_cast<uint16_t>(field), MULTIREAD, TraceOp::kContinuation});
+  }
+  ops[0].length = ops.size();
+  ops[0].flags = 0;
+  AppendTrace(ops.data(), ops.size());
+}
+
+void CoreWorkload::TraceReadModifyWrite(uint64_t key_num, uint64_t read_field, uint64_t write_field,
+                                        const std::vector<DB::Field> &values) {
+  if (trace_ == nullptr) {
+    return;
+  }
+  TraceOp ops[2] = {
+      {0, key_num, 0, static_cast<uint16_t>(read_field), READMODIFYWRITE, 0},
+      {0, key_num, static_cast<uint32_t>(ValueBytes(values)), static_cast<uint16_t>(write_field), READMODIFYWRITE,
+       TraceOp::kContinuation}};
+  AppendTrace(ops, 2);
 }
 
 bool CoreWorkload::DoInsert(DB &db) {
-  const std::string key = BuildKeyName(insert_key_sequence_->Next());
-  std::vector<DB::Field> fields;
-  BuildValues(fields);
-  return db.Insert(table_name_, key, fields) == DB::kOK;
+  OpContext &ctx = ThreadOpContext(insert_key_sequence_->Next());
+  BuildValues(ctx.values);
+  return db.Insert(table_name_, ctx.key, ctx.values) == DB::kOK;
+}
+
+// Key names do not sort like key numbers, so the ranges are cut at quantiles of a sample of
+// the load keys.
+void CoreWorkload::PlanBulkLoad(int parts) {
+  static constexpr int kSamplesPerPart = 1024;
+  bulk_splitters_.clear();
+  bulk_keys_.assign(parts, std::vector<BulkKeys>(parts));
+  bulk_keyed_ = std::make_unique<utils::CountDownLatch>(parts);
+  if (parts <= 1 || record_count_ == 0) {
+    return;
+  }
+  std::mt19937_64 rng(insert_start_ + record_count_);
+  std::uniform_int_distribution<uint64_t> key_num(insert_start_, insert_start_ + record_count_ - 1);
+  std::vector<std::string> samples;
+  for (int i = 0; i < parts * kSamplesPerPart; ++i) {
+    samples.push_back(BuildKeyName(key_num(rng)));
+  }
+  std::sort(samples.begin(), samples.end());
+  for (int i = 1; i < parts; ++i) {
+    bulk_splitters_.push_back(samples[i * kSamplesPerPart]);
+  }
+}
+
+// Every part builds the keys of its own share of the key numbers and hands each one to the
+// part whose key range holds it. Once all parts are done, a part gathers the keys handed to
+// it, packed into one buffer and sorted through an index, which is much smaller than a
+// string per key.
+int64_t CoreWorkload::DoBulkLoad(DB &db, int part) {
+  const int parts = bulk_keys_.size();
+  const uint64_t first = insert_start_ + record_count_ * part / parts;
+  const uint64_t last = insert_start_ + record_count_ * (part + 1) / parts;
+  std::string key;
+  for (uint64_t n = first; n < last; ++n) {
+    BuildKeyName(n, key);
+    size_t to = std::upper_bound(bulk_splitters_.begin(), bulk_splitters_.end(), key) - bulk_splitters_.begin();
+    BulkKeys &keys = bulk_keys_[part][to];
+    keys.packed.append(key);
+    keys.ends.push_back(keys.packed.size());
+  }
+  bulk_keyed_->CountDown();
+  bulk_keyed_->Await();
+
+  std::string packed;
+  std::vector<size_t> offsets{0};
+  for (int from = 0; from < parts; ++from) {
+    BulkKeys &keys = bulk_keys_[from][part];
+    const size_t base = packed.size();
+    packed.append(keys.packed);
+    for (size_t end : keys.ends) {
+      offsets.push_back(base + end);
+    }
+    keys = BulkKeys();
+  }
+  auto key_at = [&packed, &offsets](size_t i) {
+    return std::string_view(packed).substr(offsets[i], offsets[i + 1] - offsets[i]);
+  };
+  std::vector<size_t> order(offsets.size() - 1);
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&key_at](size_t a, size_t b) { return key_at(a) < key_at(b); });
+
+  int64_t inserted = 0;
+  std::vector<DB::Record> batch;
+  for (size_t i = 0; i < order.size(); i += bulk_batch_size_) {
+    batch.resize(std::min(order.size() - i, static_cast<size_t>(bulk_batch_size_)));
+    for (size_t j = 0; j < batch.size(); ++j) {
+      batch[j].key.assign(key_at(order[i + j]));
+      batch[j].values.clear();
+      BuildValues(batch[j].values);
+    }
+    if (db.BulkInsert(table_name_, batch) != DB::kOK) {
+      throw utils::Exception("failed to bulk insert " + std::to_string(batch.size()) + " records");
+    }
+    inserted += batch.size();
+  }
+  if (db.FinishBulkLoad(table_name_) != DB::kOK) {
+    throw utils::Exception("failed to finish bulk load");
+  }
+  return inserted;
+}
+
+// Chooses the next transaction type. A type with its own rate limit is taken only when its
+// next operation is due, otherwise one of the types without a limit is chosen in their
+// proportions, so limited types hold their rate while the others use the remaining capacity.
+// If every type is limited, waits for the last choice when no type is ready.
+ycsbc::Operation CoreWorkload::NextOperation() {
+  utils::RateLimiter *blocked;
+  uint64_t intended_start = Measurements::GetIntendedStartTime();
+  Operation op = ChooseOperation(&blocked, &intended_start);
+  if (blocked != nullptr) {
+    WaitOpLimiter(blocked, &intended_start);
+  }
+  Measurements::SetIntendedStartTime(intended_start);
+  return op;
+}
+
+// Blocks until the next operation of an operation type limiter is due.
+void CoreWorkload::WaitOpLimiter(utils::RateLimiter *limiter, uint64_t *intended_start) {
+  if (op_open_loop_) {
+    *intended_start = limiter->NextIntendedStart();
+  } else {
+    limiter->Consume(1);
+  }
+}
+
+// Chooses the next transaction type as NextOperation does, storing the intended start of an
+// open-loop limited type in *intended_start. Instead of waiting for the last choice, stores
+// its limiter in *blocked (nullptr otherwise), so the caller waits in its own way.
+ycsbc::Operation CoreWorkload::ChooseOperation(utils::RateLimiter **blocked, uint64_t *intended_start) {
+  static constexpr int kMaxChoices = 8;
+  ThreadGenerators &generators = Generators();
+  *blocked = nullptr;
+  Operation op = generators.op_chooser->Next();
+  for (int i = 1; op_limiter_[op] != nullptr; i++) {
+    utils::RateLimiter *limiter = op_limiter_[op];
+    if (i == kMaxChoices) {
+      *blocked = limiter;
+      break;
+    } else if (op_open_loop_ ? limiter->TryNextIntendedStart(intended_start) : limiter->TryConsume(1)) {
+      break;
+    } else if (generators.unlimited_op_chooser != nullptr) {
+      return generators.unlimited_op_chooser->Next();
+    }
+    op = generators.op_chooser->Next();
+  }
+  return op;
+}
+
+bool CoreWorkload::HasOpLimits() const {
+  return std::any_of(std::begin(op_limiter_), std::end(op_limiter_),
+                     [](const utils::RateLimiter *limiter) { return limiter != nullptr; });
+}
+
+void CoreWorkload::ResetOpPacing() {
+  for (utils::RateLimiter *limiter : op_limiter_) {
+    if (limiter != nullptr) {
+      limiter->Reset();
+    }
+  }
 }
 
 bool CoreWorkload::DoTransaction(DB &db) {
+  if (thread_replay_ != nullptr) {
+    return ReplayTransaction(db) == DB::kOK;
+  }
   DB::Status status;
-  switch (op_chooser_.Next()) {
+  switch (NextOperation()) {
     case READ:
       status = TransactionRead(db);
       break;
@@ -346,6 +774,9 @@ bool CoreWorkload::DoTransaction(DB &db) {
     case FILTER:
       status = TransactionFilter(db);
       break;
+    case MULTIREAD:
+      status = TransactionMultiRead(db);
+      break;
     default:
       throw utils::Exception("Operation request is not recognized!");
   }
@@ -360,76 +791,96 @@ bool CoreWorkload::DoAP(DB &db) {
 
 DB::Status CoreWorkload::TransactionRead(DB &db) {
   uint64_t key_num = NextTransactionKeyNum();
-  const std::string key = BuildKeyName(key_num);
-  std::vector<DB::Field> result;
+  OpContext &ctx = ThreadOpContext(key_num);
   if (!read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back(NextFieldName());
-    return db.Read(table_name_, key, &fields, result);
+    Trace(READ, key_num, NextField(ctx.fields));
+    return db.Read(table_name_, ctx.key, &ctx.fields, ctx.result);
+  } else {
+    Trace(READ, key_num, TraceOp::kAllFields);
+    return db.Read(table_name_, ctx.key, NULL, ctx.result);
+  }
+}
+
+DB::Status CoreWorkload::TransactionMultiRead(DB &db) {
+  OpContext &ctx = thread_ctx_;
+  ctx.fields.clear();
+  DB::RecycleRows(ctx.results);
+  ctx.key_nums.clear();
+  ctx.keys.resize(multiread_batch_size_);
+  for (int i = 0; i < multiread_batch_size_; i++) {
+    ctx.key_nums.push_back(NextTransactionKeyNum());
+    BuildKeyName(ctx.key_nums.back(), ctx.keys[i]);
+  }
+  if (!read_all_fields()) {
+    TraceMultiRead(ctx.key_nums, NextField(ctx.fields));
+    return db.MultiRead(table_name_, ctx.keys, &ctx.fields, ctx.results);
   } else {
-    return db.Read(table_name_, key, NULL, result);
+    TraceMultiRead(ctx.key_nums, TraceOp::kAllFields);
+    return db.MultiRead(table_name_, ctx.keys, NULL, ctx.results);
   }
 }
 
 DB::Status CoreWorkload::TransactionReadModifyWrite(DB &db) {
   uint64_t key_num = NextTransactionKeyNum();
-  const std::string key = BuildKeyName(key_num);
-  std::vector<DB::Field> result;
+  OpContext &ctx = ThreadOpContext(key_num);
 
+  uint64_t read_field = TraceOp::kAllFields;
   if (!read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back(NextFieldName());
-    db.Read(table_name_, key, &fields, result);
+    read_field = NextField(ctx.fields);
+    db.Read(table_name_, ctx.key, &ctx.fields, ctx.result);
   } else {
-    db.Read(table_name_, key, NULL, result);
+    db.Read(table_name_, ctx.key, NULL, ctx.result);
   }
 
-  std::vector<DB::Field> values;
+  uint64_t write_field = TraceOp::kAllFields;
   if (write_all_fields()) {
-    BuildValues(values);
+    BuildValues(ctx.values);
   } else {
-    BuildSingleValue(values);
+    write_field = BuildSingleValue(ctx.values);
   }
-  return db.Update(table_name_, key, values);
+  TraceReadModifyWrite(key_num, read_field, write_field, ctx.values);
+  return db.Update(table_name_, ctx.key, ctx.values);
 }
 
 DB::Status CoreWorkload::TransactionScan(DB &db) {
   uint64_t key_num = NextTransactionKeyNum();
-  const std::string key = BuildKeyName(key_num);
-  int len = scan_len_chooser_->Next();
-  std::vector<std::vector<DB::Field>> result;
+  OpContext &ctx = ThreadOpContext(key_num);
+  int len = Generators().scan_len_chooser->Next();
   if (!read_all_fields()) {
-    std::vector<std::string> fields;
-    fields.push_back(NextFieldName());
-    return db.Scan(table_name_, key, len, &fields, result);
+    Trace(SCAN, key_num, NextField(ctx.fields), len);
+    return db.Scan(table_name_, ctx.key, len, &ctx.fields, ctx.results);
   } else {
-    return db.Scan(table_name_, key, len, NULL, result);
+    Trace(SCAN, key_num, TraceOp::kAllFields, len);
+    return db.Scan(table_name_, ctx.key, len, NULL, ctx.results);
   }
 }
 
 DB::Status CoreWorkload::TransactionUpdate(DB &db) {
   uint64_t key_num = NextTransactionKeyNum();
-  const std::string key = BuildKeyName(key_num);
-  std::vector<DB::Field> values;
+  OpContext &ctx = ThreadOpContext(key_num);
   if (write_all_fields()) {
-    BuildValues(values);
+    BuildValues(ctx.values);
+    Trace(UPDATE, key_num, TraceOp::kAllFields, ValueBytes(ctx.values));
   } else {
-    BuildSingleValue(values);
+    uint64_t field = BuildSingleValue(ctx.values);
+    Trace(UPDATE, key_num, field, ValueBytes(ctx.values));
   }
-  return db.Update(table_name_, key, values);
+  return db.Update(table_name_, ctx.key, ctx.values);
 }
 
 DB::Status CoreWorkload::TransactionInsert(DB &db) {
   uint64_t key_num = transaction_insert_key_sequence_->Next();
-  const std::string key = BuildKeyName(key_num);
-  std::vector<DB::Field> values;
-  BuildValues(values);
-  DB::Status s = db.Insert(table_name_, key, values);
+  OpContext &ctx = ThreadOpContext(key_num);
+  BuildValues(ctx.values);
+  Trace(INSERT, key_num, TraceOp::kAllFields, ValueBytes(ctx.values));
+  DB::Status s = db.Insert(table_name_, ctx.key, ctx.values);
   transaction_insert_key_sequence_->Acknowledge(key_num);
   return s;
 }
 
 DB::Status CoreWorkload::TransactionFilter(DB &db) {
+  // filters have no key, a random one spreads them over the shards of a replay
+  Trace(FILTER, utils::ThreadLocalRandomInt(), TraceOp::kAllFields);
   std::vector<DB::Field> lvalue, rvalue;
   if (distinct_value_generator_ == nullptr) {
     BuildSingleValue(lvalue);
@@ -454,4 +905,295 @@ DB::Status CoreWorkload::TransactionFilter(DB &db) {
   }
 }
 
+// Takes the next operation of the calling thread's trace shard and waits until it is due.
+void CoreWorkload::NextReplayRequest(ReplayRequest *request) {
+  TraceReplay *replay = thread_replay_;
+  const std::vector<TraceOp> *ops = replay->reader.Next();
+  if (ops == nullptr) {
+    throw utils::Exception("Trace ended before the operation count");
+  }
+  const TraceOp &head = ops->front();
+  AwaitReplayTime(*replay->start, head.timestamp, replay->speed, replay->spin_ns);
+
+  request->op = static_cast<Operation>(head.op);
+  BuildKeyName(head.key, request->key);
+  request->length = head.length;
+  if (head.field != TraceOp::kAllFields) {
+    request->fields.push_back(FieldName(head.field));
+  }
+  switch (request->op) {
+    case MULTIREAD:
+      for (const TraceOp &op : *ops) {
+        request->keys.push_back(BuildKeyName(op.key));
+      }
+      break;
+    case UPDATE:
+    case INSERT:
+      BuildReplayValues(head.field, head.length, request->values);
+      break;
+    case READMODIFYWRITE:
+      BuildReplayValues(ops->back().field, ops->back().length, request->values);
+      break;
+    default:
+      break;
+  }
+}
+
+// Waits until an operation recorded timestamp ns into a trace is due and makes that its
+// intended start. Operations are due right away if speed is 0.
+void CoreWorkload::AwaitReplayTime(const std::chrono::steady_clock::time_point &start, uint64_t timestamp,
+                                   double speed, int64_t spin_ns) {
+  if (speed > 0) {
+    auto due = start + std::chrono::nanoseconds(static_cast<int64_t>(timestamp / speed));
+    utils::SleepUntil(due, spin_ns);
+    Measurements::SetIntendedStartTime(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(due.time_since_epoch()).count());
+  }
+}
+
+// Values of a replayed write, bytes are spread evenly over all fields if field is kAllFields.
+void CoreWorkload::BuildReplayValues(uint64_t field, uint64_t bytes, std::vector<DB::Field> &values) {
+  const int num_fields = field == TraceOp::kAllFields ? field_count_ : 1;
+  for (int i = 0; i < num_fields; ++i) {
+    values.push_back(DB::Field());
+    DB::Field &value = values.back();
+    value.name = FieldName(field == TraceOp::kAllFields ? i : field);
+    uint64_t len = bytes / num_fields + (i < static_cast<int>(bytes % num_fields) ? 1 : 0);
+    AppendValueBytes(value.value, len, true);
+  }
+}
+
+DB::Status CoreWorkload::ReplayTransaction(DB &db) {
+  ReplayRequest &request = thread_ctx_.request;
+  request.keys.clear();
+  request.fields.clear();
+  request.values.clear();
+  NextReplayRequest(&request);
+  return IssueRequest(db, request);
+}
+
+utils::Task<DB::Status> CoreWorkload::ReplayTransactionAsync(DB &db) {
+  ReplayRequest request;
+  NextReplayRequest(&request);
+  co_return co_await IssueRequestAsync(db, request);
+}
+
+DB::Status CoreWorkload::IssueRequest(DB &db, ReplayRequest &request) {
+  const std::vector<std::string> *fields = request.fields.empty() ? NULL : &request.fields;
+  std::vector<DB::Field> &result = thread_ctx_.result;
+  std::vector<std::vector<DB::Field>> &results = thread_ctx_.results;
+  result.clear();
+  DB::RecycleRows(results);
+  switch (request.op) {
+    case READ:
+      return db.Read(table_name_, request.key, fields, result);
+    case MULTIREAD:
+      return db.MultiRead(table_name_, request.keys, fields, results);
+    case SCAN:
+      return db.Scan(table_name_, request.key, request.length, fields, results);
+    case UPDATE:
+      return db.Update(table_name_, request.key, request.values);
+    case INSERT:
+      return db.Insert(table_name_, request.key, request.values);
+    case DELETE:
+      return db.Delete(table_name_, request.key);
+    case READMODIFYWRITE:
+      db.Read(table_name_, request.key, fields, result);
+      return db.Update(table_name_, request.key, request.values);
+    case FILTER:
+      return TransactionFilter(db);
+    default:
+      throw utils::Exception("Operation request is not recognized!");
+  }
+}
+
+utils::Task<DB::Status> CoreWorkload::IssueRequestAsync(DB &db, ReplayRequest &request) {
+  const std::vector<std::string> *fields = request.fields.empty() ? NULL : &request.fields;
+  std::vector<DB::Field> result;
+  std::vector<std::vector<DB::Field>> results;
+  switch (request.op) {
+    case READ:
+      co_return co_await db.ReadAsync(table_name_, request.key, fields, result);
+    case MULTIREAD:
+      co_return co_await db.MultiReadAsync(table_name_, request.keys, fields, results);
+    case SCAN:
+      co_return co_await db.ScanAsync(table_name_, request.key, request.length, fields, results);
+    case UPDATE:
+      co_return co_await db.UpdateAsync(table_name_, request.key, request.values);
+    case INSERT:
+      co_return co_await db.InsertAsync(table_name_, request.key, request.values);
+    case DELETE:
+      co_return co_await db.DeleteAsync(table_name_, request.key);
+    case READMODIFYWRITE: {
+      // other coroutines of the thread set their own intended start while the read is out
+      const uint64_t intended_start = Measurements::GetIntendedStartTime();
+      co_await db.ReadAsync(table_name_, request.key, fields, result);
+      Measurements::SetIntendedStartTime(intended_start);
+      co_return co_await db.UpdateAsync(table_name_, request.key, request.values);
+    }
+    case FILTER:
+      co_return TransactionFilter(db);
+    default:
+      throw utils::Exception("Operation request is not recognized!");
+  }
+}
+
+utils::Task<bool> CoreWorkload::DoInsertAsync(DB &db) {
+  const std::string key = BuildKeyName(insert_key_sequence_->Next());
+  std::vector<DB::Field> fields;
+  BuildValues(fields);
+  DB::Status status = co_await db.InsertAsync(table_name_, key, fields);
+  co_return (status == DB::kOK);
+}
+
+utils::Task<bool> CoreWorkload::DoTransactionAsync(DB &db) {
+  if (thread_replay_ != nullptr) {
+    co_return (co_await ReplayTransactionAsync(db)) == DB::kOK;
+  }
+  // the intended start is kept in the frame, other coroutines of the thread set their own
+  // while this one waits
+  utils::RateLimiter *blocked;
+  uint64_t intended_start = Measurements::GetIntendedStartTime();
+  const Operation op = ChooseOperation(&blocked, &intended_start);
+  if (blocked != nullptr && thread_pacing_ != nullptr) {
+    uint64_t due = op_open_loop_ ? blocked->ReserveNextIntendedStart() : blocked->Reserve(1);
+    co_await thread_pacing_->Until(due, blocked->SpinNanos());
+    blocked->Released(due);
+    if (op_open_loop_) {
+      intended_start = due;
+    }
+  } else if (blocked != nullptr) {
+    WaitOpLimiter(blocked, &intended_start);
+  }
+  Measurements::SetIntendedStartTime(intended_start);
+  DB::Status status;
+  switch (op) {
+    case READ:
+      status = co_await TransactionReadAsync(db);
+      break;
+    case UPDATE:
+      status = co_await TransactionUpdateAsync(db);
+      break;
+    case INSERT:
+      status = co_await TransactionInsertAsync(db);
+      break;
+    case SCAN:
+      status = co_await TransactionScanAsync(db);
+      break;
+    case READMODIFYWRITE:
+      status = co_await TransactionReadModifyWriteAsync(db);
+      break;
+    case FILTER:
+      status = TransactionFilter(db);
+      break;
+    case MULTIREAD:
+      status = co_await TransactionMultiReadAsync(db);
+      break;
+    default:
+      throw utils::Exception("Operation request is not recognized!");
+  }
+  co_return (status == DB::kOK);
+}
+
+utils::Task<DB::Status> CoreWorkload::TransactionReadAsync(DB &db) {
+  uint64_t key_num = NextTransactionKeyNum();
+  const std::string key = BuildKeyName(key_num);
+  std::vector<DB::Field> result;
+  std::vector<std::string> fields;
+  if (!read_all_fields()) {
+    Trace(READ, key_num, NextField(fields));
+    co_return co_await db.ReadAsync(table_name_, key, &fields, result);
+  } else {
+    Trace(READ, key_num, TraceOp::kAllFields);
+    co_return co_await db.ReadAsync(table_name_, key, NULL, result);
+  }
+}
+
+utils::Task<DB::Status> CoreWorkload::TransactionMultiReadAsync(DB &db) {
+  std::vector<uint64_t> key_nums;
+  std::vector<std::string> keys;
+  keys.reserve(multiread_batch_size_);
+  for (int i = 0; i < multiread_batch_size_; i++) {
+    key_nums.push_back(NextTransactionKeyNum());
+    keys.push_back(BuildKeyName(key_nums.back()));
+  }
+  std::vector<std::vector<DB::Field>> result;
+  std::vector<std::string> fields;
+  if (!read_all_fields()) {
+    TraceMultiRead(key_nums, NextField(fields));
+    co_return co_await db.MultiReadAsync(table_name_, keys, &fields, result);
+  } else {
+    TraceMultiRead(key_nums, TraceOp::kAllFields);
+    co_return co_await db.MultiReadAsync(table_name_, keys, NULL, result);
+  }
+}
+
+utils::Task<DB::Status> CoreWorkload::TransactionReadModifyWriteAsync(DB &db) {
+  uint64_t key_num = NextTransactionKeyNum();
+  const std::string key = BuildKeyName(key_num);
+  std::vector<DB::Field> result;
+  std::vector<std::string> fields;
+  // other coroutines of the thread set their own intended start while the read is out
+  const uint64_t intended_start = Measurements::GetIntendedStartTime();
+
+  uint64_t read_field = TraceOp::kAllFields;
+  if (!read_all_fields()) {
+    read_field = NextField(fields);
+    co_await db.ReadAsync(table_name_, key, &fields, result);
+  } else {
+    co_await db.ReadAsync(table_name_, key, NULL, result);
+  }
+  Measurements::SetIntendedStartTime(intended_start);
+
+  std::vector<DB::Field> values;
+  uint64_t write_field = TraceOp::kAllFields;
+  if (write_all_fields()) {
+    BuildValues(values);
+  } else {
+    write_field = BuildSingleValue(values);
+  }
+  TraceReadModifyWrite(key_num, read_field, write_field, values);
+  co_return co_await db.UpdateAsync(table_name_, key, values);
+}
+
+utils::Task<DB::Status> CoreWorkload::TransactionScanAsync(DB &db) {
+  uint64_t key_num = NextTransactionKeyNum();
+  const std::string key = BuildKeyName(key_num);
+  int len = Generators().scan_len_chooser->Next();
+  std::vector<std::vector<DB::Field>> result;
+  std::vector<std::string> fields;
+  if (!read_all_fields()) {
+    Trace(SCAN, key_num, NextField(fields), len);
+    co_return co_await db.ScanAsync(table_name_, key, len, &fields, result);
+  } else {
+    Trace(SCAN, key_num, TraceOp::kAllFields, len);
+    co_return co_await db.ScanAsync(table_name_, key, len, NULL, result);
+  }
+}
+
+utils::Task<DB::Status> CoreWorkload::TransactionUpdateAsync(DB &db) {
+  uint64_t key_num = NextTransactionKeyNum();
+  const std::string key = BuildKeyName(key_num);
+  std::vector<DB::Field> values;
+  if (write_all_fields()) {
+    BuildValues(values);
+    Trace(UPDATE, key_num, TraceOp::kAllFields, ValueBytes(values));
+  } else {
+    uint64_t field = BuildSingleValue(values);
+    Trace(UPDATE, key_num, field, ValueBytes(values));
+  }
+  co_return co_await db.UpdateAsync(table_name_, key, values);
+}
+
+utils::Task<DB::Status> CoreWorkload::TransactionInsertAsync(DB &db) {
+  uint64_t key_num = transaction_insert_key_sequence_->Next();
+  const std::string key = BuildKeyName(key_num);
+  std::vector<DB::Field> values;
+  BuildValues(values);
+  Trace(INSERT, key_num, TraceOp::kAllFields, ValueBytes(values));
+  DB::Status s = co_await db.InsertAsync(table_name_, key, values);
+  transaction_insert_key_sequence_->Acknowledge(key_num);
+  co_return s;
+}
+
 } // ycsbc
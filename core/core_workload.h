@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <string>
+#include <atomic>
 #include <memory>
 #include "db.h"
 #include "generator.h"
@@ -19,7 +20,14 @@
 #include "counter_generator.h"
 #include "distinct_value_generator.h"
 #include "acknowledged_counter_generator.h"
+#include "zipfian_generator.h"
+#include "scrambled_zipfian_generator.h"
+#include "op_trace.h"
+#include "utils/coroutine.h"
+#include "utils/coroutine_pacing.h"
+#include "utils/countdown_latch.h"
 #include "utils/properties.h"
+#include "utils/rate_limit.h"
 #include "utils/utils.h"
 
 namespace ycsbc {
@@ -32,6 +40,7 @@ enum Operation {
   READMODIFYWRITE,
   DELETE,
   FILTER,
+  MULTIREAD,
   INSERT_FAILED,
   READ_FAILED,
   UPDATE_FAILED,
@@ -39,6 +48,7 @@ enum Operation {
   READMODIFYWRITE_FAILED,
   DELETE_FAILED,
   FILTER_FAILED,
+  MULTIREAD_FAILED,
   MAXOPTYPE
 };
 
@@ -130,6 +140,20 @@ class CoreWorkload {
   static const std::string READMODIFYWRITE_PROPORTION_PROPERTY;
   static const std::string READMODIFYWRITE_PROPORTION_DEFAULT;
 
+  ///
+  /// The name of the property for the proportion of
+  /// batched multi-key read transactions.
+  ///
+  static const std::string MULTIREAD_PROPORTION_PROPERTY;
+  static const std::string MULTIREAD_PROPORTION_DEFAULT;
+
+  ///
+  /// The name of the property for the number of keys read by
+  /// one multi-key read transaction.
+  ///
+  static const std::string MULTIREAD_BATCH_SIZE_PROPERTY;
+  static const std::string MULTIREAD_BATCH_SIZE_DEFAULT;
+
   ///
   /// The name of the property for the proportion of
   /// filter transactions.
@@ -208,6 +232,38 @@ class CoreWorkload {
   ///
   static const std::string ZIPFIAN_CONST_PROPERTY;
 
+  ///
+  /// The name of the property for the zipfian sampling method: "gray" (the
+  /// YCSB approximation) or "rejection" (exact rejection-inversion).
+  ///
+  static const std::string ZIPFIAN_SAMPLER_PROPERTY;
+  static const std::string ZIPFIAN_SAMPLER_DEFAULT;
+
+  ///
+  /// The name of the property for drawing zipfian keys without retries: a key
+  /// not inserted yet is rescaled into the inserted range instead of drawn
+  /// again. This moves its popularity to an older key, so the distribution
+  /// is no longer zipfian over the inserted keys alone.
+  ///
+  static const std::string ZIPFIAN_RESCALE_PROPERTY;
+  static const std::string ZIPFIAN_RESCALE_DEFAULT;
+
+  ///
+  /// The name of the property for the size in bytes of a pool of random bytes
+  /// generated once, which field values are copied from at random offsets.
+  /// 0 generates fresh bytes for every value.
+  ///
+  static const std::string VALUE_POOL_SIZE_PROPERTY;
+  static const std::string VALUE_POOL_SIZE_DEFAULT;
+
+  ///
+  /// The name of the property for the target compression ratio of values.
+  /// Each value repeats a fragment of fresh random bytes, 1/ratio of its
+  /// length, like the compressible strings of db_bench. 1 keeps values random.
+  ///
+  static const std::string VALUE_COMPRESSIBILITY_PROPERTY;
+  static const std::string VALUE_COMPRESSIBILITY_DEFAULT;
+
   ///
   /// Initialize the scenario.
   /// Called once, in the main client thread, before any operations are started.
@@ -218,15 +274,89 @@ class CoreWorkload {
   virtual bool DoTransaction(DB &db);
   virtual bool DoAP(DB &db);
 
+  ///
+  /// Coroutine counterparts of DoInsert and DoTransaction for the coroutine
+  /// client. They await the asynchronous DB operations, so several of them
+  /// can be outstanding on one thread.
+  ///
+  virtual utils::Task<bool> DoInsertAsync(DB &db);
+  virtual utils::Task<bool> DoTransactionAsync(DB &db);
+
+  ///
+  /// Splits the keys of the load phase into parts disjoint, ordered key ranges
+  /// of about the same size, one per client thread of a bulk load.
+  ///
+  void PlanBulkLoad(int parts);
+
+  ///
+  /// Generates the records of key range part in ascending key order and passes
+  /// them to db.BulkInsert in batches of load.batch records, then finishes the
+  /// bulk load of db. Returns the number of records inserted. The parts hand
+  /// keys to each other, so every part planned must be loaded concurrently.
+  ///
+  int64_t DoBulkLoad(DB &db, int part);
+
+  ///
+  /// Rate limit of an operation type in ops per second, set by limit.<op>.ops
+  /// (e.g. limit.read.ops), and its limiter. nullptr if the type is not limited.
+  ///
+  int64_t OpLimit(Operation op) const { return op_limit_[op]; }
+  const utils::RateLimiter *OpLimiter(Operation op) const { return op_limiter_[op]; }
+  bool HasOpLimits() const;
+
+  ///
+  /// Restarts the per operation type limiters with empty buckets and no pacing error,
+  /// called when a measured phase starts.
+  ///
+  void ResetOpPacing();
+
+  ///
+  /// Records the transactions generated from now on to trace, nullptr to stop.
+  ///
+  void SetTrace(TraceSink *trace) { trace_ = trace; }
+
+  ///
+  /// Most trace records a single transaction produces.
+  ///
+  size_t MaxTraceRecords() const { return std::max(2, multiread_batch_size_); }
+
+  ///
+  /// Makes the transactions of the calling thread replay operations of a trace
+  /// instead of generating them, nullptr to generate again.
+  ///
+  static void SetThreadReplay(TraceReplay *replay) { thread_replay_ = replay; }
+
+  ///
+  /// Makes coroutine transactions of the calling thread wait for operation types with
+  /// their own rate limit on pacing instead of blocking the thread, nullptr to block.
+  ///
+  static void SetThreadPacing(utils::CoroutinePacing *pacing) { thread_pacing_ = pacing; }
+
+  ///
+  /// Makes transactional inserts draw keys from the sequence of other, so workloads
+  /// running side by side insert distinct keys. Must be called before Init.
+  ///
+  void ShareKeySpace(const CoreWorkload &other) {
+    transaction_insert_key_sequence_ = other.transaction_insert_key_sequence_;
+  }
+
+  ///
+  /// Number of records in the key space: the initial record count plus
+  /// acknowledged transactional inserts.
+  ///
+  uint64_t RecordCount() { return transaction_insert_key_sequence_->Last() + 1; }
+
   bool read_all_fields() const { return read_all_fields_; }
   bool write_all_fields() const { return write_all_fields_; }
 
   CoreWorkload() :
       field_count_(0), read_all_fields_(false), write_all_fields_(false),
       distinct_value_generator_(nullptr), field_len_generator_(nullptr),
-      key_chooser_(nullptr), field_chooser_(nullptr),
+      has_unlimited_ops_(false), key_chooser_(nullptr), field_chooser_(nullptr),
       scan_len_chooser_(nullptr), insert_key_sequence_(nullptr),
-      transaction_insert_key_sequence_(nullptr), ordered_inserts_(true), record_count_(0) {
+      ordered_inserts_(true), record_count_(0), insert_start_(0), bulk_batch_size_(0),
+      op_limit_(), op_limiter_(), op_open_loop_(false), trace_(nullptr), zipfian_rescale_(false),
+      epoch_(0) {
   }
 
   virtual ~CoreWorkload() {
@@ -236,44 +366,180 @@ class CoreWorkload {
     delete field_chooser_;
     delete scan_len_chooser_;
     delete insert_key_sequence_;
-    delete transaction_insert_key_sequence_;
+    for (utils::RateLimiter *limiter : op_limiter_) {
+      delete limiter;
+    }
   }
 
  protected:
   static Generator<uint64_t> *GetFieldLenGenerator(const utils::Properties &p);
-  std::string BuildKeyName(uint64_t key_num);
+  static ZipfianGenerator::Sampler GetZipfianSampler(const utils::Properties &p);
+  std::string BuildKeyName(uint64_t key_num) {
+    std::string key;
+    BuildKeyName(key_num, key);
+    return key;
+  }
+  void BuildKeyName(uint64_t key_num, std::string &key);
   void BuildValues(std::vector<DB::Field> &values);
-  void BuildSingleValue(std::vector<DB::Field> &update);
+  uint64_t BuildSingleValue(std::vector<DB::Field> &update);
 
+  Operation NextOperation();
+  Operation ChooseOperation(utils::RateLimiter **blocked, uint64_t *intended_start);
+  void WaitOpLimiter(utils::RateLimiter *limiter, uint64_t *intended_start);
   uint64_t NextTransactionKeyNum();
+  std::string FieldName(uint64_t field_num);
   std::string NextFieldName();
+  uint64_t NextField(std::vector<std::string> &fields);
+  static uint64_t ValueBytes(const std::vector<DB::Field> &values);
+
+  void Trace(Operation op, uint64_t key_num, uint64_t field, uint64_t length = 0) {
+    if (trace_ != nullptr) {
+      TraceOp record{0, key_num, static_cast<uint32_t>(length), static_cast<uint16_t>(field),
+                     static_cast<uint8_t>(op), 0};
+      AppendTrace(&record, 1);
+    }
+  }
+  void AppendTrace(TraceOp *ops, size_t n);
+  void TraceMultiRead(const std::vector<uint64_t> &key_nums, uint64_t field);
+  void TraceReadModifyWrite(uint64_t key_num, uint64_t read_field, uint64_t write_field,
+                            const std::vector<DB::Field> &values);
+
+  // operation replayed from a trace, issued by IssueRequest
+  struct ReplayRequest {
+    Operation op;
+    std::string key;
+    std::vector<std::string> keys;
+    // empty for all fields
+    std::vector<std::string> fields;
+    std::vector<DB::Field> values;
+    int length;
+  };
+  void NextReplayRequest(ReplayRequest *request);
+  // Buffers of the synchronous operations of a thread, cleared rather than freed between
+  // operations so that they keep their capacity; the rows of results go back to the DB
+  // through DB::RecycleRows. Coroutine operations of a thread overlap, so they keep their own.
+  struct OpContext {
+    std::string key;
+    std::vector<std::string> keys;
+    std::vector<uint64_t> key_nums;
+    std::vector<std::string> fields;
+    std::vector<DB::Field> values;
+    std::vector<DB::Field> result;
+    std::vector<std::vector<DB::Field>> results;
+    ReplayRequest request;
+  };
+  // operation context of the calling thread with its key set to the key of key_num
+  OpContext &ThreadOpContext(uint64_t key_num) {
+    BuildKeyName(key_num, thread_ctx_.key);
+    thread_ctx_.fields.clear();
+    thread_ctx_.result.clear();
+    DB::RecycleRows(thread_ctx_.results);
+    return thread_ctx_;
+  }
+  static void AwaitReplayTime(const std::chrono::steady_clock::time_point &start, uint64_t timestamp,
+                              double speed, int64_t spin_ns);
+  void BuildReplayValues(uint64_t field, uint64_t bytes, std::vector<DB::Field> &values);
+  void AppendValueBytes(std::string &value, uint64_t len, bool from_pool);
+  void FillValueBytes(char *out, size_t len);
+  DB::Status ReplayTransaction(DB &db);
+  utils::Task<DB::Status> ReplayTransactionAsync(DB &db);
+  DB::Status IssueRequest(DB &db, ReplayRequest &request);
+  utils::Task<DB::Status> IssueRequestAsync(DB &db, ReplayRequest &request);
 
   DB::Status TransactionRead(DB &db);
+  DB::Status TransactionMultiRead(DB &db);
   DB::Status TransactionReadModifyWrite(DB &db);
   DB::Status TransactionScan(DB &db);
   DB::Status TransactionUpdate(DB &db);
   DB::Status TransactionInsert(DB &db);
   DB::Status TransactionFilter(DB &db);
 
+  utils::Task<DB::Status> TransactionReadAsync(DB &db);
+  utils::Task<DB::Status> TransactionMultiReadAsync(DB &db);
+  utils::Task<DB::Status> TransactionReadModifyWriteAsync(DB &db);
+  utils::Task<DB::Status> TransactionScanAsync(DB &db);
+  utils::Task<DB::Status> TransactionUpdateAsync(DB &db);
+  utils::Task<DB::Status> TransactionInsertAsync(DB &db);
+
   std::string table_name_;
   int field_count_;
   std::string field_prefix_;
+  // names of fields 0 to field_count_ - 1
+  std::vector<std::string> field_names_;
   bool read_all_fields_;
   bool write_all_fields_;
+  int multiread_batch_size_;
   int numdistinct_;
   double selection_rate_;
+  // random bytes values are copied from, in value pool mode and for replayed writes
+  std::string value_pool_;
+  bool use_value_pool_;
+  double value_compressibility_;
   int key_len_;
   DistinctValueGenerator *distinct_value_generator_;
   Generator<uint64_t> *field_len_generator_;
   DiscreteGenerator<Operation> op_chooser_;
+  // op_chooser_ over the types without a rate limit
+  DiscreteGenerator<Operation> unlimited_op_chooser_;
+  bool has_unlimited_ops_;
   Generator<uint64_t> *key_chooser_; // transaction key gen
   Generator<uint64_t> *field_chooser_;
   Generator<uint64_t> *scan_len_chooser_;
   CounterGenerator *insert_key_sequence_; // load insert key gen
-  AcknowledgedCounterGenerator *transaction_insert_key_sequence_; // transaction insert key gen
+  std::shared_ptr<AcknowledgedCounterGenerator> transaction_insert_key_sequence_; // transaction insert key gen
   bool ordered_inserts_;
-  size_t record_count_;
+  uint64_t record_count_;
+  uint64_t insert_start_;
   int zero_padding_;
+  int bulk_batch_size_;
+  // lower bounds of the key ranges of a bulk load but the first
+  std::vector<std::string> bulk_splitters_;
+  // keys one part of a bulk load built for another, packed, with the end of each key
+  struct BulkKeys {
+    std::string packed;
+    std::vector<size_t> ends;
+  };
+  // bulk_keys_[from][to], handed over once every part has counted down bulk_keyed_
+  std::vector<std::vector<BulkKeys>> bulk_keys_;
+  std::unique_ptr<utils::CountDownLatch> bulk_keyed_;
+  int64_t op_limit_[MAXOPTYPE];
+  utils::RateLimiter *op_limiter_[MAXOPTYPE];
+  bool op_open_loop_;
+  TraceSink *trace_;
+  bool zipfian_rescale_;
+  static thread_local TraceReplay *thread_replay_;
+  static thread_local utils::CoroutinePacing *thread_pacing_;
+  static thread_local OpContext thread_ctx_;
+
+  // The calling thread's clones of the generators of the workload, made on first use after
+  // each Init so that threads do not share generator state. Generators without clones, such
+  // as the insert key counters, are shared.
+  struct ThreadGenerators {
+    uint64_t epoch = 0;
+    Generator<uint64_t> *key_chooser = nullptr;
+    // key_chooser if it samples below a bound, set if zipfian_rescale is
+    ScrambledZipfianGenerator *scrambled_key_chooser = nullptr;
+    Generator<uint64_t> *field_chooser = nullptr;
+    Generator<uint64_t> *scan_len_chooser = nullptr;
+    Generator<uint64_t> *field_len_generator = nullptr;
+    Generator<Operation> *op_chooser = nullptr;
+    // nullptr if every type has a rate limit
+    Generator<Operation> *unlimited_op_chooser = nullptr;
+    std::vector<std::unique_ptr<Generator<uint64_t>>> clones;
+    std::unique_ptr<Generator<Operation>> op_chooser_clone;
+    std::unique_ptr<Generator<Operation>> unlimited_op_chooser_clone;
+  };
+  ThreadGenerators &Generators() {
+    if (thread_generators_.epoch != epoch_) {
+      CloneGenerators(thread_generators_);
+    }
+    return thread_generators_;
+  }
+  void CloneGenerators(ThreadGenerators &generators);
+  // unique among all Init calls of all workloads
+  uint64_t epoch_;
+  static std::atomic<uint64_t> next_epoch_;
+  static thread_local ThreadGenerators thread_generators_;
 };
 
 } // ycsbc
@@ -11,6 +11,8 @@
 
 #include "utils/properties.h"
 
+#include <coroutine>
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -26,6 +28,10 @@ class DB {
     std::string name;
     std::string value;
   };
+  struct Record {
+    std::string key;
+    std::vector<Field> values;
+  };
   enum Status {
     kOK = 0,
     kError,
@@ -33,6 +39,46 @@ class DB {
     kNotImplemented
   };
   ///
+  /// Awaitable result of an asynchronous operation.
+  /// The synchronous fallback returns an already completed result, so the
+  /// awaiting coroutine continues without suspending. Bindings with native
+  /// asynchronous I/O return a pending result built from a submit function,
+  /// which is called when the coroutine suspends; the callback it receives
+  /// must be invoked on the same thread, typically from Poll(), once the
+  /// operation has finished.
+  ///
+  class AsyncStatus {
+   public:
+    using Callback = std::function<void(Status)>;
+    using Submitter = std::function<void(Callback)>;
+
+    AsyncStatus(Status s) : status_(s), ready_(true) {}
+    explicit AsyncStatus(Submitter submit) : status_(kOK), ready_(false), submit_(std::move(submit)) {}
+
+    bool Ready() const { return ready_; }
+    Status GetStatus() const { return status_; }
+    void Submit(Callback callback) {
+      // the awaiter may resume, and destroy this object, before submit returns
+      Submitter submit = std::move(submit_);
+      submit(std::move(callback));
+    }
+
+    bool await_ready() const noexcept { return ready_; }
+    void await_suspend(std::coroutine_handle<> awaiter) {
+      Submit([this, awaiter](Status s) {
+        status_ = s;
+        ready_ = true;
+        awaiter.resume();
+      });
+    }
+    Status await_resume() const noexcept { return status_; }
+
+   private:
+    Status status_;
+    bool ready_;
+    Submitter submit_;
+  };
+  ///
   /// Initializes any state for accessing this DB.
   ///
   virtual void Init() { }
@@ -54,6 +100,31 @@ class DB {
                    const std::vector<std::string> *fields,
                    std::vector<Field> &result) = 0;
   ///
+  /// Reads a batch of records from the database.
+  /// The default implementation issues one Read per key; bindings with a
+  /// native batched lookup should override it.
+  ///
+  /// @param table The name of the table.
+  /// @param keys The keys of the records to read.
+  /// @param fields The list of fields to read, or NULL for all of them.
+  /// @param result A vector of vector, where the i-th vector contains field/value
+  ///        pairs for keys[i] (empty if the record was not found)
+  /// @return Zero on success, or a non-zero error code if any record-miss or error.
+  ///
+  virtual Status MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                           const std::vector<std::string> *fields,
+                           std::vector<std::vector<Field>> &result) {
+    Status status = kOK;
+    ResizeRows(result, keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      Status s = Read(table, keys[i], fields, result[i]);
+      if (s != kOK) {
+        status = s;
+      }
+    }
+    return status;
+  }
+  ///
   /// Performs a range scan for a set of records in the database.
   /// Field/value pairs from the result are stored in a vector.
   ///
@@ -100,6 +171,51 @@ class DB {
   ///
   virtual Status Delete(const std::string &table, const std::string &key) = 0;
   ///
+  /// Inserts a batch of records of a bulk load into the database.
+  /// Each client thread of a bulk load passes its records in ascending key
+  /// order, and the key ranges of different threads do not overlap, so
+  /// bindings can write them through the engine's ingestion path. The
+  /// default implementation issues one Insert per record.
+  ///
+  /// @param table The name of the table.
+  /// @param records The records to insert, in ascending key order.
+  /// @return Zero on success, a non-zero error code on error.
+  ///
+  virtual Status BulkInsert(const std::string &table, std::vector<Record> &records) {
+    for (Record &record : records) {
+      Status s = Insert(table, record.key, record.values);
+      if (s != kOK) {
+        return s;
+      }
+    }
+    return kOK;
+  }
+  ///
+  /// Makes the records passed to BulkInsert by this DB instance visible.
+  /// Called once by each client thread after its last batch.
+  ///
+  /// @param table The name of the table.
+  /// @return Zero on success, a non-zero error code on error.
+  ///
+  virtual Status FinishBulkLoad(const std::string &table) { return kOK; }
+  ///
+  /// Writes a consistent copy of the database to the new directory dir with
+  /// the engine's checkpoint or backup facility. Called on an initialized
+  /// instance while no operations are running.
+  ///
+  /// @param dir The directory of the snapshot, which must not exist.
+  /// @return Zero on success, kNotImplemented if the engine has no snapshots.
+  ///
+  virtual Status Snapshot(const std::string &dir) { return kNotImplemented; }
+  ///
+  /// Replaces the database with a snapshot written by Snapshot. Called before
+  /// any instance is initialized.
+  ///
+  /// @param dir The directory of the snapshot.
+  /// @return Zero on success, kNotImplemented if the engine has no snapshots.
+  ///
+  virtual Status Restore(const std::string &dir) { return kNotImplemented; }
+  ///
   /// Filters all records whose value is in [lvalue, rvalue].
   /// Field/value pairs from the result are stored in a vector.
   ///
@@ -115,13 +231,112 @@ class DB {
                    const std::vector<DB::Field> &rvalue, const std::vector<std::string> *fields, 
                    std::vector<std::vector<Field>> &result) = 0;
 
+  ///
+  /// Asynchronous counterparts of Read, MultiRead, Scan, Update, Insert and
+  /// Delete, used by the coroutine client. The arguments must stay valid until
+  /// the result is complete. The defaults run the synchronous operation and
+  /// return a completed result.
+  ///
+  virtual AsyncStatus ReadAsync(const std::string &table, const std::string &key,
+                                const std::vector<std::string> *fields,
+                                std::vector<Field> &result) {
+    return Read(table, key, fields, result);
+  }
+  virtual AsyncStatus MultiReadAsync(const std::string &table, const std::vector<std::string> &keys,
+                                     const std::vector<std::string> *fields,
+                                     std::vector<std::vector<Field>> &result) {
+    return MultiRead(table, keys, fields, result);
+  }
+  virtual AsyncStatus ScanAsync(const std::string &table, const std::string &key,
+                                int record_count, const std::vector<std::string> *fields,
+                                std::vector<std::vector<Field>> &result) {
+    return Scan(table, key, record_count, fields, result);
+  }
+  virtual AsyncStatus UpdateAsync(const std::string &table, const std::string &key,
+                                  std::vector<Field> &values) {
+    return Update(table, key, values);
+  }
+  virtual AsyncStatus InsertAsync(const std::string &table, const std::string &key,
+                                  std::vector<Field> &values) {
+    return Insert(table, key, values);
+  }
+  virtual AsyncStatus DeleteAsync(const std::string &table, const std::string &key) {
+    return Delete(table, key);
+  }
+  ///
+  /// Completes finished asynchronous operations of this DB instance.
+  /// Called repeatedly by the coroutine client while operations are pending.
+  ///
+  virtual void Poll() { }
+  ///
+  /// Reports cumulative hit and miss counts of the engine's cache.
+  /// May be called from a thread other than the one using this instance.
+  ///
+  /// @return False if the engine does not track cache hits.
+  ///
+  virtual bool GetCacheStats(uint64_t *hits, uint64_t *misses) { return false; }
+  ///
+  /// Reports how many bytes of records the engine has written to storage,
+  /// before and after compression. Called on an initialized instance while
+  /// no operations are running; the engine may flush buffered writes first.
+  ///
+  /// @return False if the engine does not report compressed sizes.
+  ///
+  virtual bool GetCompressionStats(uint64_t *raw_bytes, uint64_t *stored_bytes) { return false; }
+
   virtual ~DB() { }
 
   void SetProps(utils::Properties *props) {
     props_ = props;
   }
+
+  ///
+  /// Empties a result of Scan, MultiRead or Filter. Its rows are kept, cleared,
+  /// for the rows that the next results of the calling thread take through
+  /// AppendRow and ResizeRows, so reused result buffers do not allocate rows.
+  ///
+  static void RecycleRows(std::vector<std::vector<Field>> &result) {
+    std::vector<std::vector<Field>> &spare = SpareRows();
+    for (std::vector<Field> &row : result) {
+      row.clear();
+      spare.push_back(std::move(row));
+    }
+    result.clear();
+  }
  protected:
+  ///
+  /// Appends an empty row to a result, reusing a row of RecycleRows if any.
+  ///
+  static std::vector<Field> &AppendRow(std::vector<std::vector<Field>> &result) {
+    std::vector<std::vector<Field>> &spare = SpareRows();
+    if (spare.empty()) {
+      return result.emplace_back();
+    }
+    result.push_back(std::move(spare.back()));
+    spare.pop_back();
+    return result.back();
+  }
+  ///
+  /// Resizes a result to n rows, the new ones appended as by AppendRow.
+  ///
+  static void ResizeRows(std::vector<std::vector<Field>> &result, size_t n) {
+    if (result.size() >= n) {
+      result.resize(n);
+      return;
+    }
+    result.reserve(n);
+    while (result.size() < n) {
+      AppendRow(result);
+    }
+  }
+
   utils::Properties *props_;
+
+ private:
+  static std::vector<std::vector<Field>> &SpareRows() {
+    static thread_local std::vector<std::vector<Field>> spare;
+    return spare;
+  }
 };
 
 } // ycsbc
@@ -8,6 +8,7 @@
 #ifndef YCSB_C_DB_WRAPPER_H_
 #define YCSB_C_DB_WRAPPER_H_
 
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -36,9 +37,21 @@ class DBWrapper : public DB {
     Status s = db_->Read(table, key, fields, result);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
-      measurements_->Report(READ, elapsed);
+      Report(READ, elapsed);
     } else {
-      measurements_->Report(READ_FAILED, elapsed);
+      Report(READ_FAILED, elapsed);
+    }
+    return s;
+  }
+  Status MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
+    timer_.Start();
+    Status s = db_->MultiRead(table, keys, fields, result);
+    uint64_t elapsed = timer_.End();
+    if (s == kOK) {
+      Report(MULTIREAD, elapsed);
+    } else {
+      Report(MULTIREAD_FAILED, elapsed);
     }
     return s;
   }
@@ -48,9 +61,9 @@ class DBWrapper : public DB {
     Status s = db_->Scan(table, key, record_count, fields, result);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
-      measurements_->Report(SCAN, elapsed);
+      Report(SCAN, elapsed);
     } else {
-      measurements_->Report(SCAN_FAILED, elapsed);
+      Report(SCAN_FAILED, elapsed);
     }
     return s;
   }
@@ -59,9 +72,9 @@ class DBWrapper : public DB {
     Status s = db_->Update(table, key, values);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
-      measurements_->Report(UPDATE, elapsed);
+      Report(UPDATE, elapsed);
     } else {
-      measurements_->Report(UPDATE_FAILED, elapsed);
+      Report(UPDATE_FAILED, elapsed);
     }
     return s;
   }
@@ -70,9 +83,9 @@ class DBWrapper : public DB {
     Status s = db_->Insert(table, key, values);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
-      measurements_->Report(INSERT, elapsed);
+      Report(INSERT, elapsed);
     } else {
-      measurements_->Report(INSERT_FAILED, elapsed);
+      Report(INSERT_FAILED, elapsed);
     }
     return s;
   }
@@ -81,12 +94,32 @@ class DBWrapper : public DB {
     Status s = db_->Delete(table, key);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
-      measurements_->Report(DELETE, elapsed);
+      Report(DELETE, elapsed);
     } else {
-      measurements_->Report(DELETE_FAILED, elapsed);
+      Report(DELETE_FAILED, elapsed);
+    }
+    return s;
+  }
+  Status BulkInsert(const std::string &table, std::vector<Record> &records) {
+    timer_.Start();
+    Status s = db_->BulkInsert(table, records);
+    uint64_t elapsed = timer_.End();
+    // the batch counts as one insert per record, each taking its share of the time
+    uint64_t share = records.empty() ? 0 : elapsed / records.size();
+    for (size_t i = 0; i < records.size(); i++) {
+      Report(s == kOK ? INSERT : INSERT_FAILED, share);
     }
     return s;
   }
+  Status FinishBulkLoad(const std::string &table) {
+    return db_->FinishBulkLoad(table);
+  }
+  Status Snapshot(const std::string &dir) {
+    return db_->Snapshot(dir);
+  }
+  Status Restore(const std::string &dir) {
+    return db_->Restore(dir);
+  }
   Status Filter(const std::string &table, const std::vector<DB::Field> &lvalue,
                 const std::vector<DB::Field> &rvalue, const std::vector<std::string> *fields,
                 std::vector<std::vector<Field>> &result) {
@@ -94,13 +127,86 @@ class DBWrapper : public DB {
     Status s = db_->Filter(table, lvalue, rvalue, fields, result);
     uint64_t elapsed = timer_.End();
     if (s == kOK) {
-      measurements_->Report(FILTER, elapsed);
+      Report(FILTER, elapsed);
     } else {
-      measurements_->Report(FILTER_FAILED, elapsed);
+      Report(FILTER_FAILED, elapsed);
     }
     return s;
   }
+  AsyncStatus ReadAsync(const std::string &table, const std::string &key,
+                        const std::vector<std::string> *fields, std::vector<Field> &result) {
+    uint64_t start = NowNanos();
+    return Measure(READ, READ_FAILED, start, db_->ReadAsync(table, key, fields, result));
+  }
+  AsyncStatus MultiReadAsync(const std::string &table, const std::vector<std::string> &keys,
+                             const std::vector<std::string> *fields,
+                             std::vector<std::vector<Field>> &result) {
+    uint64_t start = NowNanos();
+    return Measure(MULTIREAD, MULTIREAD_FAILED, start, db_->MultiReadAsync(table, keys, fields, result));
+  }
+  AsyncStatus ScanAsync(const std::string &table, const std::string &key, int record_count,
+                        const std::vector<std::string> *fields,
+                        std::vector<std::vector<Field>> &result) {
+    uint64_t start = NowNanos();
+    return Measure(SCAN, SCAN_FAILED, start, db_->ScanAsync(table, key, record_count, fields, result));
+  }
+  AsyncStatus UpdateAsync(const std::string &table, const std::string &key, std::vector<Field> &values) {
+    uint64_t start = NowNanos();
+    return Measure(UPDATE, UPDATE_FAILED, start, db_->UpdateAsync(table, key, values));
+  }
+  AsyncStatus InsertAsync(const std::string &table, const std::string &key, std::vector<Field> &values) {
+    uint64_t start = NowNanos();
+    return Measure(INSERT, INSERT_FAILED, start, db_->InsertAsync(table, key, values));
+  }
+  AsyncStatus DeleteAsync(const std::string &table, const std::string &key) {
+    uint64_t start = NowNanos();
+    return Measure(DELETE, DELETE_FAILED, start, db_->DeleteAsync(table, key));
+  }
+  void Poll() {
+    db_->Poll();
+  }
+  bool GetCacheStats(uint64_t *hits, uint64_t *misses) {
+    return db_->GetCacheStats(hits, misses);
+  }
+  bool GetCompressionStats(uint64_t *raw_bytes, uint64_t *stored_bytes) {
+    return db_->GetCompressionStats(raw_bytes, stored_bytes);
+  }
  private:
+  void Report(Operation op, uint64_t elapsed,
+              uint64_t intended_start = Measurements::GetIntendedStartTime(),
+              Measurements *thread_measurements = Measurements::GetThreadMeasurements()) {
+    measurements_->Report(op, elapsed);
+    if (thread_measurements != nullptr) {
+      thread_measurements->Report(op, elapsed);
+    }
+    if (intended_start != 0) {
+      uint64_t latency = NowNanos() - intended_start;
+      measurements_->ReportIntended(op, latency);
+      if (thread_measurements != nullptr) {
+        thread_measurements->ReportIntended(op, latency);
+      }
+    }
+  }
+  AsyncStatus Measure(Operation op, Operation failed_op, uint64_t start, AsyncStatus s) {
+    uint64_t intended_start = Measurements::GetIntendedStartTime();
+    Measurements *thread_measurements = Measurements::GetThreadMeasurements();
+    if (s.Ready()) {
+      Report(s.GetStatus() == kOK ? op : failed_op, NowNanos() - start, intended_start, thread_measurements);
+      return s;
+    }
+    return AsyncStatus([this, op, failed_op, start, intended_start, thread_measurements,
+                        s](AsyncStatus::Callback callback) mutable {
+      s.Submit([this, op, failed_op, start, intended_start, thread_measurements, callback](Status status) {
+        Report(status == kOK ? op : failed_op, NowNanos() - start, intended_start, thread_measurements);
+        callback(status);
+      });
+    });
+  }
+  static uint64_t NowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
   DB *db_;
   Measurements *measurements_;
   utils::Timer<uint64_t, std::nano> timer_;
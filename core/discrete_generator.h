@@ -27,6 +27,14 @@ class DiscreteGenerator : public Generator<Value> {
   Value Next();
   Value Last() { return last_; }
 
+  Generator<Value> *Clone() const {
+    DiscreteGenerator<Value> *clone = new DiscreteGenerator<Value>();
+    for (const auto &p : values_) {
+      clone->AddValue(p.first, p.second);
+    }
+    return clone;
+  }
+
  private:
   std::vector<std::pair<Value, double>> values_;
   double sum_;
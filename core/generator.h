@@ -18,8 +18,15 @@ class Generator {
  public:
   virtual Value Next() = 0;
   virtual Value Last() = 0;
+  ///
+  /// Returns a new generator of the same distribution for the use of a single
+  /// thread, so that threads do not share generator state. Parameters that are
+  /// costly to compute are copied. Returns nullptr if the generator is meant
+  /// to be shared by all threads, like the insert key counters.
+  ///
+  virtual Generator<Value> *Clone() const { return nullptr; }
   virtual ~Generator() { }
-  
+
 };
 
 } // ycsbc
@@ -23,57 +23,84 @@ namespace {
 
 namespace ycsbc {
 
-BasicMeasurements::BasicMeasurements() : count_{}, latency_sum_{}, latency_max_{} {
-  std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
+thread_local uint64_t Measurements::intended_start_time_ = 0;
+thread_local Measurements *Measurements::thread_measurements_ = nullptr;
+
+BasicMeasurements::BasicMeasurements() {
+  Reset(raw_);
+  Reset(intended_);
 }
 
-void BasicMeasurements::Report(Operation op, uint64_t latency) {
-  count_[op].fetch_add(1, std::memory_order_relaxed);
-  latency_sum_[op].fetch_add(latency, std::memory_order_relaxed);
-  uint64_t prev_min = latency_min_[op].load(std::memory_order_relaxed);
+void BasicMeasurements::Record(Stats &stats, Operation op, uint64_t latency) {
+  stats.count[op].fetch_add(1, std::memory_order_relaxed);
+  stats.latency_sum[op].fetch_add(latency, std::memory_order_relaxed);
+  uint64_t prev_min = stats.latency_min[op].load(std::memory_order_relaxed);
   while (prev_min > latency
-         && !latency_min_[op].compare_exchange_weak(prev_min, latency, std::memory_order_relaxed));
-  uint64_t prev_max = latency_max_[op].load(std::memory_order_relaxed);
+         && !stats.latency_min[op].compare_exchange_weak(prev_min, latency, std::memory_order_relaxed));
+  uint64_t prev_max = stats.latency_max[op].load(std::memory_order_relaxed);
   while (prev_max < latency
-         && !latency_max_[op].compare_exchange_weak(prev_max, latency, std::memory_order_relaxed));
+         && !stats.latency_max[op].compare_exchange_weak(prev_max, latency, std::memory_order_relaxed));
 }
 
-std::string BasicMeasurements::GetStatusMsg() {
-  std::ostringstream msg_stream;
-  msg_stream.precision(2);
+void BasicMeasurements::Report(Operation op, uint64_t latency) {
+  Record(raw_, op, latency);
+}
+
+void BasicMeasurements::ReportIntended(Operation op, uint64_t latency) {
+  Record(intended_, op, latency);
+}
+
+uint64_t BasicMeasurements::AppendStatus(Stats &stats, const char *prefix,
+                                         std::ostringstream &msg_stream) {
   uint64_t total_cnt = 0;
-  msg_stream << std::fixed << " operations;";
   for (int i = 0; i < MAXOPTYPE; i++) {
     Operation op = static_cast<Operation>(i);
-    uint64_t cnt = count_[op].load(std::memory_order_relaxed);
+    uint64_t cnt = stats.count[op].load(std::memory_order_relaxed);
     if (cnt == 0)
       continue;
-    msg_stream << " [" << kOperationString[op] << ":"
+    msg_stream << " [" << prefix << kOperationString[op] << ":"
                << " Count=" << cnt
-               << " Max=" << latency_max_[op].load(std::memory_order_relaxed) / 1000.0
-               << " Min=" << latency_min_[op].load(std::memory_order_relaxed) / 1000.0
+               << " Max=" << stats.latency_max[op].load(std::memory_order_relaxed) / 1000.0
+               << " Min=" << stats.latency_min[op].load(std::memory_order_relaxed) / 1000.0
                << " Avg="
                << ((cnt > 0)
-                   ? static_cast<double>(latency_sum_[op].load(std::memory_order_relaxed)) / cnt
+                   ? static_cast<double>(stats.latency_sum[op].load(std::memory_order_relaxed)) / cnt
                    : 0) / 1000.0
                << "]";
     total_cnt += cnt;
   }
+  return total_cnt;
+}
+
+std::string BasicMeasurements::GetStatusMsg() {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed << " operations;";
+  uint64_t total_cnt = AppendStatus(raw_, "", msg_stream);
+  AppendStatus(intended_, "INTENDED-", msg_stream);
   return std::to_string(total_cnt) + msg_stream.str();
 }
 
+void BasicMeasurements::Reset(Stats &stats) {
+  std::fill(std::begin(stats.count), std::end(stats.count), 0);
+  std::fill(std::begin(stats.latency_sum), std::end(stats.latency_sum), 0);
+  std::fill(std::begin(stats.latency_min), std::end(stats.latency_min), std::numeric_limits<uint64_t>::max());
+  std::fill(std::begin(stats.latency_max), std::end(stats.latency_max), 0);
+}
+
 void BasicMeasurements::Reset() {
-  std::fill(std::begin(count_), std::end(count_), 0);
-  std::fill(std::begin(latency_sum_), std::end(latency_sum_), 0);
-  std::fill(std::begin(latency_min_), std::end(latency_min_), std::numeric_limits<uint64_t>::max());
-  std::fill(std::begin(latency_max_), std::end(latency_max_), 0);
+  Reset(raw_);
+  Reset(intended_);
 }
 
 #ifdef HDRMEASUREMENT
 HdrHistogramMeasurements::HdrHistogramMeasurements() {
   for (int op = 0; op < MAXOPTYPE; op++) {
     if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &histogram_[op]) != 0) {
-      utils::Exception("hdr init failed");
+      throw utils::Exception("hdr init failed");
+    }
+    if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &intended_histogram_[op]) != 0) {
+      throw utils::Exception("hdr init failed");
     }
   }
 }
@@ -82,34 +109,97 @@ void HdrHistogramMeasurements::Report(Operation op, uint64_t latency) {
   hdr_record_value_atomic(histogram_[op], latency);
 }
 
-std::string HdrHistogramMeasurements::GetStatusMsg() {
-  std::ostringstream msg_stream;
-  msg_stream.precision(2);
+void HdrHistogramMeasurements::ReportIntended(Operation op, uint64_t latency) {
+  hdr_record_value_atomic(intended_histogram_[op], latency);
+}
+
+uint64_t HdrHistogramMeasurements::AppendStatus(hdr_histogram *const *histogram, const char *prefix,
+                                                std::ostringstream &msg_stream) {
   uint64_t total_cnt = 0;
-  msg_stream << std::fixed << " operations;";
   for (int i = 0; i < MAXOPTYPE; i++) {
     Operation op = static_cast<Operation>(i);
-    uint64_t cnt = histogram_[op]->total_count;
+    uint64_t cnt = histogram[op]->total_count;
     if (cnt == 0)
       continue;
-    msg_stream << " [" << kOperationString[op] << ":"
+    msg_stream << " [" << prefix << kOperationString[op] << ":"
                << " Count=" << cnt
-               << " Max=" << hdr_max(histogram_[op]) / 1000.0
-               << " Min=" << hdr_min(histogram_[op]) / 1000.0
-               << " Avg=" << hdr_mean(histogram_[op]) / 1000.0
-               << " 90=" << hdr_value_at_percentile(histogram_[op], 90) / 1000.0
-               << " 99=" << hdr_value_at_percentile(histogram_[op], 99) / 1000.0
-               << " 99.9=" << hdr_value_at_percentile(histogram_[op], 99.9) / 1000.0
-               << " 99.99=" << hdr_value_at_percentile(histogram_[op], 99.99) / 1000.0
+               << " Max=" << hdr_max(histogram[op]) / 1000.0
+               << " Min=" << hdr_min(histogram[op]) / 1000.0
+               << " Avg=" << hdr_mean(histogram[op]) / 1000.0
+               << " 90=" << hdr_value_at_percentile(histogram[op], 90) / 1000.0
+               << " 99=" << hdr_value_at_percentile(histogram[op], 99) / 1000.0
+               << " 99.9=" << hdr_value_at_percentile(histogram[op], 99.9) / 1000.0
+               << " 99.99=" << hdr_value_at_percentile(histogram[op], 99.99) / 1000.0
                << "]";
     total_cnt += cnt;
   }
+  return total_cnt;
+}
+
+std::string HdrHistogramMeasurements::GetStatusMsg() {
+  std::ostringstream msg_stream;
+  msg_stream.precision(2);
+  msg_stream << std::fixed << " operations;";
+  uint64_t total_cnt = AppendStatus(histogram_, "", msg_stream);
+  AppendStatus(intended_histogram_, "INTENDED-", msg_stream);
   return std::to_string(total_cnt) + msg_stream.str();
 }
 
+hdr_histogram *HdrHistogramMeasurements::Total(hdr_histogram *const *histogram) {
+  hdr_histogram *total;
+  if (hdr_init(10, 100LL * 1000 * 1000 * 1000, 3, &total) != 0) {
+    return nullptr;
+  }
+  for (int op = 0; op < MAXOPTYPE; op++) {
+    hdr_add(total, histogram[op]);
+  }
+  return total;
+}
+
+HdrHistogramMeasurements::HdrSnapshot::~HdrSnapshot() {
+  if (total != nullptr) {
+    hdr_close(total);
+  }
+  if (intended_total != nullptr) {
+    hdr_close(intended_total);
+  }
+}
+
+std::unique_ptr<Measurements::Snapshot> HdrHistogramMeasurements::TakeSnapshot() {
+  std::unique_ptr<HdrSnapshot> snapshot(new HdrSnapshot());
+  snapshot->total = Total(histogram_);
+  snapshot->intended_total = Total(intended_histogram_);
+  if (snapshot->total == nullptr || snapshot->intended_total == nullptr) {
+    return nullptr;
+  }
+  return snapshot;
+}
+
+bool HdrHistogramMeasurements::GetLatencySummary(double percentile, bool intended, const Snapshot *since,
+                                                 uint64_t *count, uint64_t *latency) {
+  hdr_histogram *total = Total(intended ? intended_histogram_ : histogram_);
+  if (total == nullptr) {
+    return false;
+  }
+  if (since != nullptr) {
+    // all histograms share their layout, so the counts subtract bucket by bucket
+    const HdrSnapshot *snapshot = static_cast<const HdrSnapshot *>(since);
+    const hdr_histogram *before = intended ? snapshot->intended_total : snapshot->total;
+    for (int32_t i = 0; i < total->counts_len; i++) {
+      total->counts[i] -= before->counts[i];
+    }
+    hdr_reset_internal_counters(total);
+  }
+  *count = total->total_count;
+  *latency = hdr_value_at_percentile(total, percentile);
+  hdr_close(total);
+  return true;
+}
+
 void HdrHistogramMeasurements::Reset() {
   for (int op = 0; op < MAXOPTYPE; op++) {
     hdr_reset(histogram_[op]);
+    hdr_reset(intended_histogram_[op]);
   }
 }
 #endif
@@ -12,6 +12,8 @@
 #include "utils/properties.h"
 
 #include <atomic>
+#include <memory>
+#include <sstream>
 
 #ifdef HDRMEASUREMENT
 #include <hdr/hdr_histogram.h>
@@ -24,21 +26,75 @@ namespace ycsbc {
 class Measurements {
  public:
   virtual void Report(Operation op, uint64_t latency) = 0;
+  ///
+  /// Reports the latency measured from the intended start time of the operation
+  /// (open-loop mode), i.e. corrected for coordinated omission.
+  ///
+  virtual void ReportIntended(Operation op, uint64_t latency) = 0;
   virtual std::string GetStatusMsg() = 0;
   virtual void Reset() = 0;
+  ///
+  /// Latencies of all operation types recorded up to some point of a run.
+  ///
+  class Snapshot {
+   public:
+    virtual ~Snapshot() = default;
+  };
+  ///
+  /// Takes a snapshot to measure the operations recorded after it, without resetting
+  /// the measurements while other threads report. Returns nullptr if percentiles are
+  /// not tracked.
+  ///
+  virtual std::unique_ptr<Snapshot> TakeSnapshot() { return nullptr; }
+  ///
+  /// Gets the number of operations recorded since snapshot since (or since the last
+  /// Reset if since is nullptr) and the latency (nanoseconds) at percentile over all
+  /// operation types, measured from the intended start time if intended is set.
+  /// Returns false if percentiles are not tracked.
+  ///
+  virtual bool GetLatencySummary(double percentile, bool intended, const Snapshot *since, uint64_t *count,
+                                 uint64_t *latency) {
+    return false;
+  }
+
+  ///
+  /// Intended start time (steady clock, nanoseconds) of the operation currently
+  /// issued by the calling thread, or 0 if operations are not paced open-loop.
+  ///
+  static void SetIntendedStartTime(uint64_t ns) { intended_start_time_ = ns; }
+  static uint64_t GetIntendedStartTime() { return intended_start_time_; }
+
+  ///
+  /// Measurements the calling thread reports to in addition to the global ones,
+  /// e.g. those of its thread group, or nullptr.
+  ///
+  static void SetThreadMeasurements(Measurements *measurements) { thread_measurements_ = measurements; }
+  static Measurements *GetThreadMeasurements() { return thread_measurements_; }
+ private:
+  static thread_local uint64_t intended_start_time_;
+  static thread_local Measurements *thread_measurements_;
 };
 
 class BasicMeasurements : public Measurements {
  public:
   BasicMeasurements();
   void Report(Operation op, uint64_t latency) override;
+  void ReportIntended(Operation op, uint64_t latency) override;
   std::string GetStatusMsg() override;
   void Reset() override;
  private:
-  std::atomic<uint> count_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_sum_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_min_[MAXOPTYPE];
-  std::atomic<uint64_t> latency_max_[MAXOPTYPE];
+  struct Stats {
+    std::atomic<uint64_t> count[MAXOPTYPE];
+    std::atomic<uint64_t> latency_sum[MAXOPTYPE];
+    std::atomic<uint64_t> latency_min[MAXOPTYPE];
+    std::atomic<uint64_t> latency_max[MAXOPTYPE];
+  };
+  static void Record(Stats &stats, Operation op, uint64_t latency);
+  static uint64_t AppendStatus(Stats &stats, const char *prefix, std::ostringstream &msg_stream);
+  static void Reset(Stats &stats);
+
+  Stats raw_;
+  Stats intended_;
 };
 
 #ifdef HDRMEASUREMENT
@@ -46,10 +102,26 @@ class HdrHistogramMeasurements : public Measurements {
  public:
   HdrHistogramMeasurements();
   void Report(Operation op, uint64_t latency) override;
+  void ReportIntended(Operation op, uint64_t latency) override;
   std::string GetStatusMsg() override;
   void Reset() override;
+  std::unique_ptr<Snapshot> TakeSnapshot() override;
+  bool GetLatencySummary(double percentile, bool intended, const Snapshot *since, uint64_t *count,
+                         uint64_t *latency) override;
  private:
+  struct HdrSnapshot : public Snapshot {
+    ~HdrSnapshot() override;
+    hdr_histogram *total = nullptr;
+    hdr_histogram *intended_total = nullptr;
+  };
+
+  // histogram of all operation types, nullptr if it cannot be allocated
+  static hdr_histogram *Total(hdr_histogram *const *histogram);
+  static uint64_t AppendStatus(hdr_histogram *const *histogram, const char *prefix,
+                               std::ostringstream &msg_stream);
+
   hdr_histogram *histogram_[MAXOPTYPE];
+  hdr_histogram *intended_histogram_[MAXOPTYPE];
 };
 #endif
 
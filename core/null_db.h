@@ -0,0 +1,53 @@
+//
+//  null_db.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_NULL_DB_H_
+#define YCSB_C_NULL_DB_H_
+
+#include "db.h"
+
+#include <string>
+#include <vector>
+
+namespace ycsbc {
+
+///
+/// DB that accepts every operation and does nothing, used to run a workload
+/// only for the operations it generates.
+///
+class NullDB : public DB {
+ public:
+  Status Read(const std::string &table, const std::string &key,
+              const std::vector<std::string> *fields, std::vector<Field> &result) {
+    return kOK;
+  }
+
+  Status Scan(const std::string &table, const std::string &key, int len,
+              const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
+    return kOK;
+  }
+
+  Status Update(const std::string &table, const std::string &key, std::vector<Field> &values) {
+    return kOK;
+  }
+
+  Status Insert(const std::string &table, const std::string &key, std::vector<Field> &values) {
+    return kOK;
+  }
+
+  Status Delete(const std::string &table, const std::string &key) {
+    return kOK;
+  }
+
+  Status Filter(const std::string &table, const std::vector<DB::Field> &lvalue,
+                const std::vector<DB::Field> &rvalue, const std::vector<std::string> *fields,
+                std::vector<std::vector<Field>> &result) {
+    return kOK;
+  }
+};
+
+} // ycsbc
+
+#endif // YCSB_C_NULL_DB_H_
@@ -0,0 +1,88 @@
+//
+//  op_stream.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_OP_STREAM_H_
+#define YCSB_C_OP_STREAM_H_
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "op_trace.h"
+#include "utils/huge_pages.h"
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// Operations generated ahead of a run, one segment per client thread. The
+/// segments live in huge page backed memory, so a client thread replaying its
+/// segment only streams through fixed-size records.
+///
+class OpStream : public TraceSink {
+ public:
+  ///
+  /// Room for segment_ops[i] operations of up to records_per_op records in segment i.
+  ///
+  OpStream(const std::vector<int64_t> &segment_ops, size_t records_per_op)
+      : buffer_(Records(segment_ops, records_per_op) * sizeof(TraceOp)) {
+    TraceOp *next = reinterpret_cast<TraceOp *>(buffer_.data());
+    for (int64_t ops : segment_ops) {
+      segments_.push_back({next, next, next + ops * records_per_op});
+      next += ops * records_per_op;
+    }
+  }
+
+  ///
+  /// Makes operations appended by the calling thread go to segment i.
+  ///
+  void SetThreadSegment(int i) { thread_segment_ = &segments_[i]; }
+
+  void Append(TraceOp *ops, size_t n, uint64_t start) override {
+    Segment *segment = thread_segment_;
+    if (segment->end + n > segment->limit) {
+      throw utils::Exception("operation stream segment is full");
+    }
+    memcpy(segment->end, ops, n * sizeof(TraceOp));
+    segment->end += n;
+  }
+
+  const TraceOp *begin(int i) const { return segments_[i].begin; }
+  const TraceOp *end(int i) const { return segments_[i].end; }
+
+  ///
+  /// Bytes of generated operations.
+  ///
+  size_t Bytes() const {
+    size_t bytes = 0;
+    for (const Segment &segment : segments_) {
+      bytes += (segment.end - segment.begin) * sizeof(TraceOp);
+    }
+    return bytes;
+  }
+
+ private:
+  struct Segment {
+    TraceOp *begin;
+    TraceOp *end;
+    TraceOp *limit;
+  };
+
+  static size_t Records(const std::vector<int64_t> &segment_ops, size_t records_per_op) {
+    size_t records = 0;
+    for (int64_t ops : segment_ops) {
+      records += ops * records_per_op;
+    }
+    return records;
+  }
+
+  utils::HugePageBuffer buffer_;
+  std::vector<Segment> segments_;
+  static inline thread_local Segment *thread_segment_ = nullptr;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_OP_STREAM_H_
@@ -0,0 +1,385 @@
+//
+//  op_trace.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_OP_TRACE_H_
+#define YCSB_C_OP_TRACE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "utils/utils.h"
+
+namespace ycsbc {
+
+///
+/// Operation of a binary trace, as generated by CoreWorkload.
+/// A multiread is stored as one record per key, the first one holding the
+/// number of keys in length and the others marked kContinuation. A
+/// read-modify-write is stored as its read followed by its write.
+///
+struct TraceOp {
+  static constexpr uint16_t kAllFields = 0xffff;
+  static constexpr uint8_t kContinuation = 1;
+
+  // intended start in nanoseconds since the first operation of the trace
+  uint64_t timestamp;
+  // key number
+  uint64_t key;
+  // bytes written to all fields, records scanned or keys of a multiread
+  uint32_t length;
+  // field number, kAllFields for all fields
+  uint16_t field;
+  // Operation
+  uint8_t op;
+  uint8_t flags;
+};
+static_assert(sizeof(TraceOp) == 24, "trace records must stay 24 bytes");
+
+constexpr char kTraceMagic[8] = {'Y', 'C', 'S', 'B', 'T', 'R', 'C', '1'};
+
+///
+/// Shard of a trace operation when it is replayed by num_shards threads.
+///
+inline int TraceShard(uint64_t key, int num_shards) {
+  return static_cast<int>(utils::Hash(key) % num_shards);
+}
+
+///
+/// Destination of the operations CoreWorkload generates.
+///
+class TraceSink {
+ public:
+  virtual ~TraceSink() = default;
+
+  ///
+  /// Appends n operations, timestamped with start (steady clock, nanoseconds).
+  /// The operations of one call stay contiguous.
+  ///
+  virtual void Append(TraceOp *ops, size_t n, uint64_t start) = 0;
+};
+
+///
+/// Appends operations of many threads to a trace file. Each thread fills its own
+/// buffer, which is written out as a whole so multireads stay contiguous. The
+/// buffers go to a temporary file as runs sorted by timestamp, one run per
+/// thread unless its timestamps go back, and Close merges the runs into the
+/// trace so that it is in timestamp order.
+///
+class TraceWriter : public TraceSink {
+ public:
+  explicit TraceWriter(const std::string &path)
+      : id_(next_id_.fetch_add(1)), runs_path_(path + ".runs"), output_(path, std::ios::binary),
+        runs_output_(runs_path_, std::ios::binary) {
+    if (!output_ || !runs_output_) {
+      throw utils::Exception("failed to open trace: " + path);
+    }
+    output_.write(kTraceMagic, sizeof(kTraceMagic));
+  }
+
+  ~TraceWriter() { Close(); }
+
+  void Append(TraceOp *ops, size_t n, uint64_t start) override {
+    uint64_t origin = origin_.load(std::memory_order_relaxed);
+    if (origin == 0 && origin_.compare_exchange_strong(origin, start, std::memory_order_relaxed)) {
+      origin = start;
+    }
+    Local &local = LocalBuffer();
+    if (local.ops.size() + n > kBufferOps) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Flush(&local);
+    }
+    for (size_t i = 0; i < n; i++) {
+      ops[i].timestamp = start > origin ? start - origin : 0;
+      local.ops.push_back(ops[i]);
+    }
+  }
+
+  ///
+  /// Writes out all buffers and merges the runs into the trace, the client
+  /// threads must be done.
+  ///
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!runs_output_.is_open()) {
+      return;
+    }
+    for (auto &local : locals_) {
+      Flush(local.get());
+    }
+    locals_.clear();
+    runs_output_.close();
+    Merge();
+    runs_.clear();
+    output_.close();
+    std::remove(runs_path_.c_str());
+  }
+
+ private:
+  static constexpr size_t kBufferOps = 4096;
+
+  // records of a run at an offset of the runs file
+  struct Chunk {
+    uint64_t offset;
+    uint64_t ops;
+  };
+
+  struct Local {
+    std::vector<TraceOp> ops;
+    // run of the thread, -1 before its first flush
+    int64_t run = -1;
+    uint64_t last_timestamp = 0;
+  };
+
+  Local &LocalBuffer() {
+    thread_local uint64_t owner = 0;
+    thread_local Local *local = nullptr;
+    if (owner != id_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      locals_.push_back(std::make_unique<Local>());
+      locals_.back()->ops.reserve(kBufferOps);
+      local = locals_.back().get();
+      owner = id_;
+    }
+    return *local;
+  }
+
+  // Sorts the buffer by timestamp, keeping each operation with its continuation
+  // records, and appends it to the run of the thread. The mutex must be held.
+  void Flush(Local *local) {
+    std::vector<TraceOp> &ops = local->ops;
+    if (ops.empty()) {
+      return;
+    }
+    std::vector<std::pair<size_t, size_t>> groups;
+    bool sorted = true;
+    for (size_t i = 0; i < ops.size(); i++) {
+      if (!(ops[i].flags & TraceOp::kContinuation) || groups.empty()) {
+        sorted = sorted && (groups.empty() || ops[groups.back().first].timestamp <= ops[i].timestamp);
+        groups.emplace_back(i, i + 1);
+      } else {
+        groups.back().second = i + 1;
+      }
+    }
+    if (!sorted) {
+      std::stable_sort(groups.begin(), groups.end(), [&ops](const auto &a, const auto &b) {
+        return ops[a.first].timestamp < ops[b.first].timestamp;
+      });
+      std::vector<TraceOp> sorted_ops;
+      sorted_ops.reserve(kBufferOps);
+      for (const auto &group : groups) {
+        sorted_ops.insert(sorted_ops.end(), ops.begin() + group.first, ops.begin() + group.second);
+      }
+      ops.swap(sorted_ops);
+    }
+    if (local->run < 0 || ops.front().timestamp < local->last_timestamp) {
+      local->run = runs_.size();
+      runs_.emplace_back();
+    }
+    runs_[local->run].push_back({runs_ops_, ops.size()});
+    runs_output_.write(reinterpret_cast<const char *>(ops.data()), ops.size() * sizeof(TraceOp));
+    runs_ops_ += ops.size();
+    local->last_timestamp = ops.back().timestamp;
+    ops.clear();
+  }
+
+  // Reads the records of one run in order.
+  class RunCursor {
+   public:
+    RunCursor(std::ifstream *input, const std::vector<Chunk> *chunks) : input_(input), chunks_(chunks) {
+      Fill();
+    }
+    bool Valid() const { return pos_ < buffer_.size(); }
+    const TraceOp &Get() const { return buffer_[pos_]; }
+    void Advance() {
+      if (++pos_ == buffer_.size()) {
+        Fill();
+      }
+    }
+
+   private:
+    void Fill() {
+      buffer_.clear();
+      pos_ = 0;
+      while (chunk_ < chunks_->size() && read_ == (*chunks_)[chunk_].ops) {
+        chunk_++;
+        read_ = 0;
+      }
+      if (chunk_ == chunks_->size()) {
+        return;
+      }
+      const Chunk &chunk = (*chunks_)[chunk_];
+      uint64_t n = std::min<uint64_t>(kReadOps, chunk.ops - read_);
+      buffer_.resize(n);
+      input_->seekg((chunk.offset + read_) * sizeof(TraceOp));
+      input_->read(reinterpret_cast<char *>(buffer_.data()), n * sizeof(TraceOp));
+      read_ += n;
+    }
+
+    static constexpr uint64_t kReadOps = 1024;
+    std::ifstream *input_;
+    const std::vector<Chunk> *chunks_;
+    size_t chunk_ = 0;
+    uint64_t read_ = 0;
+    std::vector<TraceOp> buffer_;
+    size_t pos_ = 0;
+  };
+
+  // Merges the runs by timestamp. Ties go to the run started first, which keeps
+  // the records of one operation, which share a timestamp, together.
+  void Merge() {
+    std::ifstream input(runs_path_, std::ios::binary);
+    if (!input) {
+      throw utils::Exception("failed to read trace runs: " + runs_path_);
+    }
+    std::vector<RunCursor> cursors;
+    cursors.reserve(runs_.size());
+    using Head = std::pair<uint64_t, size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t i = 0; i < runs_.size(); i++) {
+      cursors.emplace_back(&input, &runs_[i]);
+      if (cursors[i].Valid()) {
+        heads.emplace(cursors[i].Get().timestamp, i);
+      }
+    }
+    std::vector<TraceOp> out;
+    out.reserve(kBufferOps);
+    while (!heads.empty()) {
+      RunCursor &cursor = cursors[heads.top().second];
+      heads.pop();
+      out.push_back(cursor.Get());
+      if (out.size() == kBufferOps) {
+        output_.write(reinterpret_cast<const char *>(out.data()), out.size() * sizeof(TraceOp));
+        out.clear();
+      }
+      cursor.Advance();
+      if (cursor.Valid()) {
+        heads.emplace(cursor.Get().timestamp, &cursor - cursors.data());
+      }
+    }
+    output_.write(reinterpret_cast<const char *>(out.data()), out.size() * sizeof(TraceOp));
+  }
+
+  static inline std::atomic<uint64_t> next_id_{1};
+  const uint64_t id_;
+  const std::string runs_path_;
+  std::atomic<uint64_t> origin_{0};
+  std::mutex mutex_;
+  std::ofstream output_;
+  std::ofstream runs_output_;
+  uint64_t runs_ops_ = 0;
+  std::vector<std::vector<Chunk>> runs_;
+  std::vector<std::unique_ptr<Local>> locals_;
+};
+
+///
+/// Reads the operations of one shard of a trace file, or all operations of an
+/// OpStream segment, in order.
+///
+class TraceReader {
+ public:
+  TraceReader(const std::string &path, int shard, int num_shards)
+      : input_(path, std::ios::binary), shard_(shard), num_shards_(num_shards) {
+    char magic[sizeof(kTraceMagic)];
+    if (!input_ || !input_.read(magic, sizeof(magic)) || memcmp(magic, kTraceMagic, sizeof(magic)) != 0) {
+      throw utils::Exception("not a trace file: " + path);
+    }
+  }
+
+  TraceReader(const TraceOp *begin, const TraceOp *end)
+      : shard_(0), num_shards_(1), pos_(begin), end_(end), in_memory_(true) {}
+
+  ///
+  /// Next operation of the shard, with its continuation records.
+  /// Returns nullptr at the end of the trace.
+  ///
+  const std::vector<TraceOp> *Next() {
+    batch_.clear();
+    while (true) {
+      if (!Peek()) {
+        return batch_.empty() ? nullptr : &batch_;
+      }
+      const TraceOp &op = *pos_;
+      if (op.flags & TraceOp::kContinuation) {
+        if (!batch_.empty()) {
+          batch_.push_back(op);
+        }
+      } else if (!batch_.empty()) {
+        return &batch_;
+      } else if (TraceShard(op.key, num_shards_) == shard_) {
+        batch_.push_back(op);
+      }
+      pos_++;
+    }
+  }
+
+  ///
+  /// Operations of each of num_shards shards, multireads counted once.
+  ///
+  static std::vector<int64_t> CountShards(const std::string &path, int num_shards) {
+    std::vector<int64_t> counts(num_shards);
+    TraceReader reader(path, 0, 1);
+    while (reader.Peek()) {
+      const TraceOp &op = *reader.pos_++;
+      if (!(op.flags & TraceOp::kContinuation)) {
+        counts[TraceShard(op.key, num_shards)]++;
+      }
+    }
+    return counts;
+  }
+
+ private:
+  static constexpr size_t kBufferOps = 4096;
+
+  bool Peek() {
+    if (pos_ < end_) {
+      return true;
+    }
+    if (in_memory_) {
+      return false;
+    }
+    buffer_.resize(kBufferOps);
+    input_.read(reinterpret_cast<char *>(buffer_.data()), kBufferOps * sizeof(TraceOp));
+    buffer_.resize(input_.gcount() / sizeof(TraceOp));
+    pos_ = buffer_.data();
+    end_ = pos_ + buffer_.size();
+    return !buffer_.empty();
+  }
+
+  std::ifstream input_;
+  const int shard_;
+  const int num_shards_;
+  std::vector<TraceOp> buffer_;
+  // records not read yet, in buffer_ or in memory
+  const TraceOp *pos_ = nullptr;
+  const TraceOp *end_ = nullptr;
+  const bool in_memory_ = false;
+  std::vector<TraceOp> batch_;
+};
+
+///
+/// Replay of one trace shard by a client thread. Operations are due at *start plus
+/// their timestamp divided by speed, or right away if speed is 0.
+///
+struct TraceReplay {
+  TraceReader reader;
+  const std::chrono::steady_clock::time_point *start;
+  double speed;
+  int64_t spin_ns;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_OP_TRACE_H_
@@ -11,6 +11,7 @@
 
 #include "generator.h"
 
+#include <cassert>
 #include <cstdint>
 
 #include "zipfian_generator.h"
@@ -20,11 +21,15 @@ namespace ycsbc {
 
 class ScrambledZipfianGenerator : public Generator<uint64_t> {
  public:
-  ScrambledZipfianGenerator(uint64_t min, uint64_t max, double zipfian_const) :
+  ScrambledZipfianGenerator(uint64_t min, uint64_t max, double zipfian_const,
+                            ZipfianGenerator::Sampler sampler = ZipfianGenerator::Sampler::kGray) :
       base_(min), num_items_(max - min + 1),
-      generator_(zipfian_const == kUsedZipfianConstant ?
+      generator_(sampler == ZipfianGenerator::Sampler::kRejection ?
+                    ZipfianGenerator(0, kItemCount, zipfian_const, sampler) :
+                 zipfian_const == kUsedZipfianConstant ?
                     ZipfianGenerator(0, kItemCount, zipfian_const, kZetan) :
-                    ZipfianGenerator(0, kItemCount, zipfian_const)) { }
+                    ZipfianGenerator(0, kItemCount, zipfian_const)),
+      last_(Scramble(generator_.Last())) { }
 
   ScrambledZipfianGenerator(uint64_t min, uint64_t max) :
       ScrambledZipfianGenerator(min, max, ZipfianGenerator::kZipfianConst) { }
@@ -35,6 +40,18 @@ class ScrambledZipfianGenerator : public Generator<uint64_t> {
   uint64_t Next();
   uint64_t Last();
 
+  ///
+  /// Returns a key no larger than max, for a key space filled from min up to
+  /// max, without drawing again. A rank whose key lies above max is rescaled
+  /// into [min, max] by shifting out low bits of its offset. Its popularity
+  /// thus goes to a key in the lower part of the range, in addition to that
+  /// key's own, and moves whenever the filled range doubles; rejecting keys
+  /// above max instead keeps the distribution over [min, max] exact.
+  ///
+  uint64_t Next(uint64_t max);
+
+  Generator<uint64_t> *Clone() const { return new ScrambledZipfianGenerator(*this); }
+
  private:
   static constexpr double kUsedZipfianConstant = 0.99;
   static constexpr double kZetan = 26.46902820178302;
@@ -42,6 +59,7 @@ class ScrambledZipfianGenerator : public Generator<uint64_t> {
   const uint64_t base_;
   const uint64_t num_items_;
   ZipfianGenerator generator_;
+  uint64_t last_;
 
   uint64_t Scramble(uint64_t value) const;
 };
@@ -51,11 +69,25 @@ inline uint64_t ScrambledZipfianGenerator::Scramble(uint64_t value) const {
 }
 
 inline uint64_t ScrambledZipfianGenerator::Next() {
-  return Scramble(generator_.Next());
+  return last_ = Scramble(generator_.Next());
+}
+
+inline uint64_t ScrambledZipfianGenerator::Next(uint64_t max) {
+  assert(max >= base_);
+  uint64_t offset = Scramble(generator_.Next()) - base_;
+  const uint64_t filled = max - base_;
+  if (offset > filled) {
+    int shift = 1;
+    while (((num_items_ - 1) >> shift) > filled) {
+      shift++;
+    }
+    offset >>= shift;
+  }
+  return last_ = base_ + offset;
 }
 
 inline uint64_t ScrambledZipfianGenerator::Last() {
-  return Scramble(generator_.Last());
+  return last_;
 }
 
 }
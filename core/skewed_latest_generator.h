@@ -20,13 +20,20 @@ namespace ycsbc {
 
 class SkewedLatestGenerator : public Generator<uint64_t> {
  public:
-  SkewedLatestGenerator(CounterGenerator &counter) :
-      basis_(counter), zipfian_(basis_.Last()) {
+  SkewedLatestGenerator(CounterGenerator &counter,
+                        ZipfianGenerator::Sampler sampler = ZipfianGenerator::Sampler::kGray) :
+      basis_(counter), zipfian_(0, basis_.Last() - 1, ZipfianGenerator::kZipfianConst, sampler) {
     Next();
   }
-  
+
   uint64_t Next();
   uint64_t Last() { return last_; }
+
+  // clones share the counter
+  Generator<uint64_t> *Clone() const { return new SkewedLatestGenerator(*this); }
+
+  SkewedLatestGenerator(const SkewedLatestGenerator &other) :
+      basis_(other.basis_), zipfian_(other.zipfian_), last_(other.last_.load()) {}
  private:
   CounterGenerator &basis_;
   ZipfianGenerator zipfian_;
@@ -0,0 +1,486 @@
+//
+//  trace_workload.cc
+//  YCSB-cpp
+//
+
+#include "trace_workload.h"
+
+#include <cstring>
+#include <functional>
+
+using ycsbc::ExternalTraceCursor;
+using ycsbc::TraceWorkload;
+using std::string;
+
+const string TraceWorkload::TRACE_FILE_PROPERTY = "trace.file";
+
+const string TraceWorkload::TRACE_FORMAT_PROPERTY = "trace.format";
+const string TraceWorkload::TRACE_FORMAT_DEFAULT = "twitter";
+
+const string TraceWorkload::TRACE_SPEED_PROPERTY = "trace.speed";
+const string TraceWorkload::TRACE_SPEED_DEFAULT = "1";
+
+const string TraceWorkload::TRACE_SCAN_LENGTH_PROPERTY = "trace.scanlength";
+const string TraceWorkload::TRACE_SCAN_LENGTH_DEFAULT = "100";
+
+thread_local ExternalTraceCursor *TraceWorkload::thread_cursor_ = nullptr;
+
+namespace {
+
+// record types and payload fields of RocksDB's trace format (trace_replay.h)
+enum RocksDBTraceType : uint8_t {
+  kTraceBegin = 1,
+  kTraceEnd = 2,
+  kTraceWrite = 3,
+  kTraceGet = 4,
+  kTraceIteratorSeek = 5,
+  kTraceIteratorSeekForPrev = 6,
+  kTraceMultiGet = 13,
+};
+
+enum RocksDBPayloadType {
+  kWriteBatchData = 1,
+  kGetCFID = 2,
+  kGetKey = 3,
+  kIterCFID = 4,
+  kIterKey = 5,
+  kIterLowerBound = 6,
+  kIterUpperBound = 7,
+  kMultiGetSize = 8,
+  kMultiGetCFIDs = 9,
+  kMultiGetKeys = 10,
+};
+
+// record header: timestamp in us (fixed64), type (1 byte), payload size (fixed32)
+constexpr size_t kRocksDBRecordHeader = 13;
+constexpr char kRocksDBTraceMagic[] = "feedcafedeadbeef";
+
+void Malformed() {
+  throw ycsbc::utils::Exception("malformed rocksdb trace");
+}
+
+uint32_t DecodeFixed32(const char *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint64_t DecodeFixed64(const char *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint32_t GetFixed32(std::string_view *in) {
+  if (in->size() < 4) {
+    Malformed();
+  }
+  uint32_t v = DecodeFixed32(in->data());
+  in->remove_prefix(4);
+  return v;
+}
+
+uint32_t GetVarint32(std::string_view *in) {
+  uint32_t v = 0;
+  for (int shift = 0; shift <= 28; shift += 7) {
+    if (in->empty()) {
+      break;
+    }
+    uint8_t byte = in->front();
+    in->remove_prefix(1);
+    v |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return v;
+    }
+  }
+  Malformed();
+  return 0;
+}
+
+std::string_view GetLengthPrefixed(std::string_view *in) {
+  uint32_t len = GetVarint32(in);
+  if (in->size() < len) {
+    Malformed();
+  }
+  std::string_view value = in->substr(0, len);
+  in->remove_prefix(len);
+  return value;
+}
+
+// fields of a query record of trace version 0.2 and later
+struct QueryPayload {
+  std::string_view write_batch;
+  std::string_view key;
+  std::vector<std::string_view> keys;
+};
+
+void DecodePayload(std::string_view in, QueryPayload *payload) {
+  if (in.size() < 8) {
+    Malformed();
+  }
+  uint64_t map = DecodeFixed64(in.data());
+  in.remove_prefix(8);
+  uint32_t multiget_size = 0;
+  for (int field = 0; map != 0; ++field, map >>= 1) {
+    if ((map & 1) == 0) {
+      continue;
+    }
+    switch (field) {
+      case kWriteBatchData:
+        payload->write_batch = GetLengthPrefixed(&in);
+        break;
+      case kGetKey:
+      case kIterKey:
+        payload->key = GetLengthPrefixed(&in);
+        break;
+      case kGetCFID:
+      case kIterCFID:
+        GetFixed32(&in);
+        break;
+      case kIterLowerBound:
+      case kIterUpperBound:
+        GetLengthPrefixed(&in);
+        break;
+      case kMultiGetSize:
+        multiget_size = GetFixed32(&in);
+        break;
+      case kMultiGetCFIDs:
+        for (uint32_t i = 0; i < multiget_size; ++i) {
+          GetFixed32(&in);
+        }
+        break;
+      case kMultiGetKeys:
+        for (uint32_t i = 0; i < multiget_size; ++i) {
+          payload->keys.push_back(GetLengthPrefixed(&in));
+        }
+        break;
+      default:
+        Malformed();
+    }
+  }
+}
+
+// Twitter cache trace operations
+bool TwitterOperation(std::string_view name, ycsbc::Operation *op) {
+  if (name == "get" || name == "gets") {
+    *op = ycsbc::READ;
+  } else if (name == "set" || name == "add") {
+    *op = ycsbc::INSERT;
+  } else if (name == "replace" || name == "cas" || name == "append" || name == "prepend" ||
+             name == "incr" || name == "decr") {
+    *op = ycsbc::UPDATE;
+  } else if (name == "delete") {
+    *op = ycsbc::DELETE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+uint64_t ParseUint(std::string_view field) {
+  uint64_t v = 0;
+  for (char c : field) {
+    if (c < '0' || c > '9') {
+      break;
+    }
+    v = v * 10 + (c - '0');
+  }
+  return v;
+}
+
+} // namespace
+
+ExternalTraceCursor::ExternalTraceCursor(const utils::MappedFile &file, ExternalTraceFormat format,
+                                         int shard, int num_shards)
+    : pos_(file.begin()), end_(file.end()), format_(format), shard_(shard), num_shards_(num_shards) {
+}
+
+int ExternalTraceCursor::Shard(std::string_view key, int num_shards) {
+  return static_cast<int>(std::hash<std::string_view>{}(key) % num_shards);
+}
+
+bool ExternalTraceCursor::Next(ExternalTraceOp *op) {
+  if (format_ == ExternalTraceFormat::kTwitter) {
+    return NextTwitter(op);
+  }
+  return NextRocksDB(op);
+}
+
+bool ExternalTraceCursor::NextTwitter(ExternalTraceOp *op) {
+  while (pos_ < end_) {
+    const char *eol = static_cast<const char *>(memchr(pos_, '\n', end_ - pos_));
+    if (eol == nullptr) {
+      eol = end_;
+    }
+    std::string_view line(pos_, eol - pos_);
+    pos_ = eol < end_ ? eol + 1 : end_;
+
+    std::string_view fields[6];
+    int n = 0;
+    while (n < 6) {
+      size_t comma = line.find(',');
+      fields[n++] = line.substr(0, comma);
+      if (comma == std::string_view::npos) {
+        break;
+      }
+      line.remove_prefix(comma + 1);
+    }
+    if (n < 6) {
+      continue;
+    }
+    uint64_t seconds = ParseUint(fields[0]);
+    if (!has_origin_) {
+      origin_ = seconds;
+      has_origin_ = true;
+    }
+    if (!Owns(fields[1]) || !TwitterOperation(fields[5], &op->op)) {
+      continue;
+    }
+    op->timestamp = (seconds > origin_ ? seconds - origin_ : 0) * 1000000000;
+    op->key = fields[1];
+    op->keys.clear();
+    op->value_size = static_cast<uint32_t>(ParseUint(fields[3]));
+    return true;
+  }
+  return false;
+}
+
+bool ExternalTraceCursor::NextRocksDB(ExternalTraceOp *op) {
+  while (true) {
+    if (batch_pos_ < batch_.size()) {
+      *op = batch_[batch_pos_++];
+      return true;
+    }
+    if (static_cast<size_t>(end_ - pos_) < kRocksDBRecordHeader) {
+      return false;
+    }
+    const uint64_t micros = DecodeFixed64(pos_);
+    const uint8_t type = pos_[8];
+    const uint32_t size = DecodeFixed32(pos_ + 9);
+    if (static_cast<size_t>(end_ - pos_) - kRocksDBRecordHeader < size) {
+      if (!has_origin_) {
+        throw utils::Exception("not a rocksdb trace");
+      }
+      Malformed();
+    }
+    std::string_view payload(pos_ + kRocksDBRecordHeader, size);
+    pos_ += kRocksDBRecordHeader + size;
+
+    if (!has_origin_) {
+      if (type != kTraceBegin || payload.compare(0, sizeof(kRocksDBTraceMagic) - 1, kRocksDBTraceMagic) != 0) {
+        throw utils::Exception("not a rocksdb trace");
+      }
+      size_t version = payload.find("Trace Version: ");
+      if (version != std::string_view::npos) {
+        std::string_view number = payload.substr(version + 15);
+        size_t dot = number.find('.');
+        version_ = static_cast<int>(ParseUint(number) * 10 +
+                                    (dot == std::string_view::npos ? 0 : ParseUint(number.substr(dot + 1))));
+      }
+      origin_ = micros;
+      has_origin_ = true;
+      continue;
+    }
+    const uint64_t timestamp = (micros > origin_ ? micros - origin_ : 0) * 1000;
+
+    QueryPayload query;
+    if (version_ >= 2) {
+      if (type == kTraceWrite || type == kTraceGet || type == kTraceIteratorSeek ||
+          type == kTraceIteratorSeekForPrev || type == kTraceMultiGet) {
+        DecodePayload(payload, &query);
+      }
+    } else if (type == kTraceWrite) {
+      query.write_batch = payload;
+    } else if (type == kTraceGet || type == kTraceIteratorSeek || type == kTraceIteratorSeekForPrev) {
+      // column family id followed by the key
+      GetFixed32(&payload);
+      query.key = payload;
+    }
+
+    op->timestamp = timestamp;
+    op->keys.clear();
+    op->value_size = 0;
+    switch (type) {
+      case kTraceEnd:
+        pos_ = end_;
+        return false;
+      case kTraceWrite:
+        ReadWriteBatch(query.write_batch, timestamp);
+        continue;
+      case kTraceGet:
+        op->op = READ;
+        op->key = query.key;
+        break;
+      case kTraceIteratorSeek:
+      case kTraceIteratorSeekForPrev:
+        op->op = SCAN;
+        op->key = query.key;
+        break;
+      case kTraceMultiGet:
+        if (query.keys.empty()) {
+          continue;
+        }
+        op->op = MULTIREAD;
+        op->key = query.keys.front();
+        op->keys = std::move(query.keys);
+        break;
+      default:
+        continue;
+    }
+    if (Owns(op->key)) {
+      return true;
+    }
+  }
+}
+
+// Splits a WriteBatch into single key operations of this shard. Puts become inserts,
+// merges updates and deletes deletes; range deletions and markers are skipped.
+void ExternalTraceCursor::ReadWriteBatch(std::string_view rep, uint64_t timestamp) {
+  batch_.clear();
+  batch_pos_ = 0;
+  // sequence number (fixed64) and count (fixed32)
+  if (rep.size() < 12) {
+    Malformed();
+  }
+  rep.remove_prefix(12);
+  while (!rep.empty()) {
+    const uint8_t tag = rep.front();
+    rep.remove_prefix(1);
+    ExternalTraceOp op{timestamp, INSERT, {}, {}, 0};
+    bool has_op = true;
+    switch (tag) {
+      case 0x5:   // column family value
+      case 0x10:  // column family blob index
+      case 0x17:  // column family wide column entity
+        GetVarint32(&rep);
+        [[fallthrough]];
+      case 0x1:   // value
+      case 0x11:  // blob index
+      case 0x16:  // wide column entity
+        op.key = GetLengthPrefixed(&rep);
+        op.value_size = static_cast<uint32_t>(GetLengthPrefixed(&rep).size());
+        break;
+      case 0x6:   // column family merge
+        GetVarint32(&rep);
+        [[fallthrough]];
+      case 0x2:   // merge
+        op.op = UPDATE;
+        op.key = GetLengthPrefixed(&rep);
+        op.value_size = static_cast<uint32_t>(GetLengthPrefixed(&rep).size());
+        break;
+      case 0x4:   // column family deletion
+      case 0x8:   // column family single deletion
+        GetVarint32(&rep);
+        [[fallthrough]];
+      case 0x0:   // deletion
+      case 0x7:   // single deletion
+      case 0x14:  // deletion with timestamp
+        op.op = DELETE;
+        op.key = GetLengthPrefixed(&rep);
+        break;
+      case 0xE:   // column family range deletion
+        GetVarint32(&rep);
+        [[fallthrough]];
+      case 0xF:   // range deletion
+        GetLengthPrefixed(&rep);
+        GetLengthPrefixed(&rep);
+        has_op = false;
+        break;
+      case 0x3:   // log data
+      case 0xA:   // end prepare
+      case 0xB:   // commit
+      case 0xC:   // rollback
+        GetLengthPrefixed(&rep);
+        has_op = false;
+        break;
+      case 0x15:  // commit with timestamp
+        GetLengthPrefixed(&rep);
+        GetLengthPrefixed(&rep);
+        has_op = false;
+        break;
+      case 0x9:   // begin prepare
+      case 0xD:   // noop
+      case 0x12:  // begin persisted prepare
+      case 0x13:  // begin unprepare
+        has_op = false;
+        break;
+      default:
+        Malformed();
+    }
+    if (has_op && Owns(op.key)) {
+      batch_.push_back(op);
+    }
+  }
+}
+
+void TraceWorkload::Init(const utils::Properties &p) {
+  CoreWorkload::Init(p);
+
+  if (!p.ContainsKey(TRACE_FILE_PROPERTY)) {
+    throw utils::Exception(TRACE_FILE_PROPERTY + " is not set");
+  }
+  const std::string format = p.GetProperty(TRACE_FORMAT_PROPERTY, TRACE_FORMAT_DEFAULT);
+  if (format == "twitter") {
+    format_ = ExternalTraceFormat::kTwitter;
+  } else if (format == "rocksdb") {
+    format_ = ExternalTraceFormat::kRocksDB;
+  } else {
+    throw utils::Exception("Unknown trace format: " + format);
+  }
+  file_ = std::make_unique<utils::MappedFile>(p[TRACE_FILE_PROPERTY]);
+  speed_ = std::stod(p.GetProperty(TRACE_SPEED_PROPERTY, TRACE_SPEED_DEFAULT));
+  if (speed_ < 0) {
+    throw utils::Exception(TRACE_SPEED_PROPERTY + " must not be negative");
+  }
+  // a timed replay waits for each operation on the thread, which would stall the other
+  // coroutines of the thread, and these would take operations of the shard out of order
+  if (speed_ > 0 && std::stoi(p.GetProperty("client.inflight", "1")) > 1) {
+    throw utils::Exception(TRACE_SPEED_PROPERTY + " > 0 requires client.inflight=1");
+  }
+  spin_ns_ = std::stoll(p.GetProperty("limit.spin_us", "100")) * 1000;
+  scan_length_ = std::stoi(p.GetProperty(TRACE_SCAN_LENGTH_PROPERTY, TRACE_SCAN_LENGTH_DEFAULT));
+}
+
+std::vector<int64_t> TraceWorkload::CountShards(int num_shards) const {
+  std::vector<int64_t> counts(num_shards);
+  ExternalTraceCursor cursor(*file_, format_, -1, num_shards);
+  ExternalTraceOp op;
+  while (cursor.Next(&op)) {
+    counts[ExternalTraceCursor::Shard(op.key, num_shards)]++;
+  }
+  return counts;
+}
+
+// Takes the next operation of the calling thread's shard and waits until it is due.
+void TraceWorkload::NextRequest(ReplayRequest *request) {
+  ExternalTraceOp op;
+  if (thread_cursor_ == nullptr || !thread_cursor_->Next(&op)) {
+    throw utils::Exception("Trace ended before the operation count");
+  }
+  AwaitReplayTime(*start_, op.timestamp, speed_, spin_ns_);
+
+  request->op = op.op;
+  request->key.assign(op.key);
+  request->length = scan_length_;
+  for (std::string_view key : op.keys) {
+    request->keys.emplace_back(key);
+  }
+  if (op.op == INSERT || op.op == UPDATE) {
+    BuildReplayValues(TraceOp::kAllFields, op.value_size, request->values);
+  }
+}
+
+bool TraceWorkload::DoTransaction(DB &db) {
+  ReplayRequest &request = thread_ctx_.request;
+  request.keys.clear();
+  request.fields.clear();
+  request.values.clear();
+  NextRequest(&request);
+  return IssueRequest(db, request) == DB::kOK;
+}
+
+ycsbc::utils::Task<bool> TraceWorkload::DoTransactionAsync(DB &db) {
+  ReplayRequest request;
+  NextRequest(&request);
+  co_return (co_await IssueRequestAsync(db, request)) == DB::kOK;
+}
@@ -0,0 +1,150 @@
+//
+//  trace_workload.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_TRACE_WORKLOAD_H_
+#define YCSB_C_TRACE_WORKLOAD_H_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core_workload.h"
+#include "utils/mapped_file.h"
+#include "utils/properties.h"
+
+namespace ycsbc {
+
+enum class ExternalTraceFormat {
+  // Twitter cache trace CSV: timestamp,key,key size,value size,client id,operation,ttl
+  kTwitter,
+  // binary query trace written by RocksDB's DB::StartTrace
+  kRocksDB
+};
+
+///
+/// Operation of an external trace. Keys point into the mapped trace file.
+///
+struct ExternalTraceOp {
+  // nanoseconds since the first record of the trace
+  uint64_t timestamp;
+  Operation op;
+  std::string_view key;
+  // all keys of a multiread
+  std::vector<std::string_view> keys;
+  uint32_t value_size;
+};
+
+///
+/// Reads the operations of one shard of an external trace in order. Every cursor
+/// walks the whole mapping and keeps the operations whose key hashes to its shard,
+/// so the operations on a key keep their order.
+///
+class ExternalTraceCursor {
+ public:
+  ExternalTraceCursor(const utils::MappedFile &file, ExternalTraceFormat format, int shard, int num_shards);
+
+  ///
+  /// Next operation of the shard, false at the end of the trace.
+  ///
+  bool Next(ExternalTraceOp *op);
+
+  static int Shard(std::string_view key, int num_shards);
+
+ private:
+  bool NextTwitter(ExternalTraceOp *op);
+  bool NextRocksDB(ExternalTraceOp *op);
+  void ReadWriteBatch(std::string_view rep, uint64_t timestamp);
+  bool Owns(std::string_view key) const { return shard_ < 0 || Shard(key, num_shards_) == shard_; }
+
+  const char *pos_;
+  const char *end_;
+  const ExternalTraceFormat format_;
+  const int shard_;
+  const int num_shards_;
+  bool has_origin_ = false;
+  uint64_t origin_ = 0;
+  // RocksDB trace version times 10, payloads carry a field map from 2 on
+  int version_ = 0;
+  // operations of the last write batch not handed out yet
+  std::vector<ExternalTraceOp> batch_;
+  size_t batch_pos_ = 0;
+};
+
+///
+/// Workload whose transactions are the operations of an external trace in trace.file,
+/// read through a memory mapping. Each client thread replays one shard of the trace,
+/// issuing an operation at its recorded time divided by trace.speed, or back to back
+/// if trace.speed is 0. Writes carry random values of the recorded size.
+///
+class TraceWorkload : public CoreWorkload {
+ public:
+  ///
+  /// Path of the trace.
+  ///
+  static const std::string TRACE_FILE_PROPERTY;
+
+  ///
+  /// Format of the trace: twitter or rocksdb.
+  ///
+  static const std::string TRACE_FORMAT_PROPERTY;
+  static const std::string TRACE_FORMAT_DEFAULT;
+
+  ///
+  /// Replay speed relative to the recorded timestamps, 0 for as fast as possible.
+  /// Only 0 is allowed with more than one operation in flight per client thread.
+  ///
+  static const std::string TRACE_SPEED_PROPERTY;
+  static const std::string TRACE_SPEED_DEFAULT;
+
+  ///
+  /// Records read by a scan, traces only record where an iterator seeks.
+  ///
+  static const std::string TRACE_SCAN_LENGTH_PROPERTY;
+  static const std::string TRACE_SCAN_LENGTH_DEFAULT;
+
+  void Init(const utils::Properties &p) override;
+
+  bool DoTransaction(DB &db) override;
+  utils::Task<bool> DoTransactionAsync(DB &db) override;
+
+  ///
+  /// Operations of each of num_shards shards.
+  ///
+  std::vector<int64_t> CountShards(int num_shards) const;
+
+  ///
+  /// Cursor over shard of num_shards.
+  ///
+  std::unique_ptr<ExternalTraceCursor> NewCursor(int shard, int num_shards) const {
+    return std::make_unique<ExternalTraceCursor>(*file_, format_, shard, num_shards);
+  }
+
+  ///
+  /// Start of the replay, operations are timed from *start.
+  ///
+  void SetStart(const std::chrono::steady_clock::time_point *start) { start_ = start; }
+
+  ///
+  /// Makes the calling thread replay the operations of cursor.
+  ///
+  static void SetThreadCursor(ExternalTraceCursor *cursor) { thread_cursor_ = cursor; }
+
+ private:
+  void NextRequest(ReplayRequest *request);
+
+  std::unique_ptr<utils::MappedFile> file_;
+  ExternalTraceFormat format_;
+  double speed_;
+  int64_t spin_ns_;
+  int scan_length_;
+  const std::chrono::steady_clock::time_point *start_ = nullptr;
+  static thread_local ExternalTraceCursor *thread_cursor_;
+};
+
+} // ycsbc
+
+#endif // YCSB_C_TRACE_WORKLOAD_H_
@@ -24,6 +24,13 @@ class UniformGenerator : public Generator<uint64_t> {
   uint64_t Next();
   uint64_t Last();
 
+  // clones draw from their own engine, seeded at random
+  Generator<uint64_t> *Clone() const {
+    UniformGenerator *clone = new UniformGenerator(dist_.a(), dist_.b());
+    clone->generator_.seed(std::random_device()());
+    return clone;
+  }
+
  private:
   std::mt19937_64 generator_;
   std::uniform_int_distribution<uint64_t> dist_;
@@ -7,21 +7,33 @@
 //
 
 #include <cstring>
+#include <cmath>
 #include <ctime>
 
+#include <algorithm>
 #include <string>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <thread>
 #include <future>
+#include <functional>
 #include <chrono>
+#include <filesystem>
 #include <iomanip>
+#include <memory>
 
 #include "client.h"
 #include "core_workload.h"
 #include "db_factory.h"
+#include "trace_workload.h"
 #include "measurements.h"
+#include "null_db.h"
+#include "op_stream.h"
+#include "utils/affinity.h"
+#include "utils/arrival_pattern.h"
 #include "utils/countdown_latch.h"
+#include "utils/op_budget.h"
 #include "utils/rate_limit.h"
 #include "utils/timer.h"
 #include "utils/utils.h"
@@ -52,8 +64,7 @@ void StatusThread(ycsbc::Measurements *measurements, ycsbc::utils::CountDownLatc
   };
 }
 
-void RateLimitThread(std::string rate_file, std::vector<ycsbc::utils::RateLimiter *> rate_limiters,
-                     ycsbc::utils::CountDownLatch *latch) {
+void RateLimitThread(std::string rate_file, ycsbc::utils::RateLimiter *rlim, ycsbc::utils::CountDownLatch *latch) {
   std::ifstream ifs;
   ifs.open(rate_file);
 
@@ -61,8 +72,6 @@ void RateLimitThread(std::string rate_file, std::vector<ycsbc::utils::RateLimite
     ycsbc::utils::Exception("failed to open: " + rate_file);
   }
 
-  int64_t num_threads = rate_limiters.size();
-
   int64_t last_time = 0;
   while (!ifs.eof()) {
     int64_t next_time;
@@ -79,21 +88,1115 @@ void RateLimitThread(std::string rate_file, std::vector<ycsbc::utils::RateLimite
     }
     last_time = next_time;
 
-    for (auto x : rate_limiters) {
-      x->SetRate(next_rate / num_threads);
+    rlim->SetRate(next_rate);
+  }
+}
+
+// rate limit settings of a transaction phase
+struct RateOptions {
+  // initial ops per second, unlimited if <= 0
+  int64_t ops_limit;
+  // rate file path for dynamic rate limiting, format "time_stamp_sec new_ops_per_second" per line
+  std::string rate_file;
+  // issue operations on a fixed schedule and also measure latency from the intended start time
+  bool open_loop;
+
+  bool Limited() const { return ops_limit > 0 || rate_file != ""; }
+};
+
+RateOptions ReadRateOptions(const ycsbc::utils::Properties &props, const ycsbc::CoreWorkload &wl) {
+  RateOptions rate;
+  rate.ops_limit = std::stoll(props.GetProperty("limit.ops", "0"));
+  rate.rate_file = props.GetProperty("limit.file", "");
+  rate.open_loop = ycsbc::utils::StrToBool(props.GetProperty("limit.openloop", "false"));
+  if (rate.open_loop && !rate.Limited() && !wl.HasOpLimits()) {
+    std::cerr << "limit.openloop requires limit.ops, limit.file or limit.<op>.ops" << std::endl;
+    exit(1);
+  }
+  if (props.ContainsKey("limit.pattern") && !rate.Limited()) {
+    std::cerr << "limit.pattern requires limit.ops or limit.file" << std::endl;
+    exit(1);
+  }
+  return rate;
+}
+
+// Creates the arrival process named by limit.pattern, nullptr for evenly spaced operations.
+ycsbc::utils::ArrivalPattern *NewArrivalPattern(const ycsbc::utils::Properties &props) {
+  const std::string pattern = props.GetProperty("limit.pattern", "uniform");
+  // relative rate swing and period in seconds of periodic patterns
+  const double amplitude = std::stod(props.GetProperty("limit.pattern.amplitude", "0.5"));
+  const double period = std::stod(props.GetProperty("limit.pattern.period", "60"));
+  if (pattern == "uniform") {
+    return nullptr;
+  } else if (pattern == "poisson") {
+    return new ycsbc::utils::PoissonArrival();
+  } else if (pattern == "bursty") {
+    // operations per burst and ops per second within a burst, back to back if 0
+    return new ycsbc::utils::BurstArrival(std::stoll(props.GetProperty("limit.burst.size", "100")),
+                                          std::stoll(props.GetProperty("limit.burst.rate", "0")));
+  } else if (pattern == "sine") {
+    return new ycsbc::utils::SineArrival(amplitude, period);
+  } else if (pattern == "diurnal") {
+    return new ycsbc::utils::DiurnalArrival(amplitude, period);
+  }
+  std::cerr << "Unknown limit.pattern: " << pattern << std::endl;
+  exit(1);
+}
+
+// Creates the rate limiter shared by all client threads of a phase, starting at ops_limit
+// operations per second with bursts of up to one second worth of operations.
+ycsbc::utils::RateLimiter *NewRateLimiter(const ycsbc::utils::Properties &props, int64_t ops_limit) {
+  // spin instead of sleeping for the last microseconds of every wait
+  const int64_t spin_us = std::stoll(props.GetProperty("limit.spin_us", "100"));
+  ycsbc::utils::RateLimiter *rlim = new ycsbc::utils::RateLimiter(ops_limit, ops_limit, spin_us * 1000);
+  rlim->SetPattern(NewArrivalPattern(props));
+  return rlim;
+}
+
+// Reports how late operations were released compared to their due time and, for a fixed
+// target rate, how far the achieved throughput is off.
+void PrintPacing(const std::string &label, const ycsbc::utils::RateLimiter *rlim, int64_t target,
+                 double throughput) {
+  if (rlim == nullptr) {
+    return;
+  }
+  const ycsbc::utils::RateLimiter::PacingError error = rlim->GetPacingError();
+  std::cout << label << " pacing mean error(us): " << error.mean_us << std::endl;
+  std::cout << label << " pacing max error(us): " << error.max_us << std::endl;
+  if (target > 0) {
+    std::cout << label << " pacing rate error(%): " << (throughput - target) / target * 100 << std::endl;
+  }
+}
+
+// Reports the pacing of operation types with their own limit.<op>.ops rate limit.
+void PrintOpPacing(const std::string &label, const ycsbc::CoreWorkload &wl, double runtime) {
+  for (int op = 0; op < ycsbc::MAXOPTYPE; op++) {
+    const ycsbc::utils::RateLimiter *limiter = wl.OpLimiter(static_cast<ycsbc::Operation>(op));
+    if (limiter == nullptr) {
+      continue;
+    }
+    const std::string op_label = label + " " + ycsbc::kOperationString[op];
+    const double throughput = limiter->GetPacingError().ops / runtime;
+    std::cout << op_label << " throughput(ops/sec): " << throughput << std::endl;
+    PrintPacing(op_label, limiter, wl.OpLimit(static_cast<ycsbc::Operation>(op)), throughput);
+  }
+}
+
+// runs f(args...) on a new thread bound to cpus, the affinity applied by the OS is stored to applied
+template <typename F, typename... Args>
+std::future<int64_t> PinnedAsync(const std::vector<int> &cpus, std::vector<int> *applied, F f, Args... args) {
+  return std::async(std::launch::async, [=]() -> int64_t {
+    try {
+      *applied = ycsbc::utils::SetThreadAffinity(cpus);
+    } catch (const ycsbc::utils::Exception &e) {
+      std::cerr << "Caught exception: " << e.what() << std::endl;
+      exit(1);
+    }
+    return f(args...);
+  });
+}
+
+std::vector<std::vector<int>> PlanPlacement(int num_threads, const std::string &cpuset, const std::string &policy) {
+  try {
+    return ycsbc::utils::PlanThreadPlacement(num_threads, cpuset, policy);
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << e.what() << std::endl;
+    exit(1);
+  }
+}
+
+// client thread settings of a phase
+struct ClientOptions {
+  int threads;
+  // outstanding operations per client thread, > 1 runs coroutine clients
+  int inflight;
+  // time limit of the phase in seconds, unlimited if <= 0
+  double max_execution_time;
+  // operations a client thread claims at once from the budget shared by all threads
+  int64_t op_chunk;
+  std::vector<std::vector<int>> placement;
+  // print status periodically
+  bool show_status;
+  int status_interval;
+};
+
+ClientOptions ReadClientOptions(const ycsbc::utils::Properties &props) {
+  ClientOptions opt;
+  opt.threads = std::stoi(props.GetProperty("threadcount", "1"));
+  opt.inflight = std::stoi(props.GetProperty("client.inflight", "1"));
+  if (opt.inflight < 1) {
+    std::cerr << "client.inflight must be at least 1" << std::endl;
+    exit(1);
+  }
+  opt.max_execution_time = std::stod(props.GetProperty("maxexecutiontime", "0"));
+  opt.op_chunk = std::stoll(props.GetProperty("client.opchunk", "100"));
+  // cpus usable by client threads (default: all), e.g. "0-7,16-23", and none, compact, scatter or per-node
+  opt.placement = PlanPlacement(opt.threads, props.GetProperty("client.cpuset", ""),
+                                props.GetProperty("client.numa_policy", "none"));
+  opt.show_status = (props.GetProperty("status", "false") == "true");
+  opt.status_interval = std::stoi(props.GetProperty("status.interval", "10"));
+  return opt;
+}
+
+// operations of a transaction phase, unlimited if the phase is only bounded by time
+int64_t TransactionCount(const ycsbc::utils::Properties &props, const ClientOptions &opt) {
+  int64_t total_ops = std::stoll(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
+  if (total_ops <= 0 && opt.max_execution_time > 0) {
+    total_ops = ycsbc::utils::OpBudget::kUnlimited;
+  }
+  return total_ops;
+}
+
+// Starts a client thread on dbs[i], initializing the DB unless it is ready. The thread runs
+// thread_init, if set, before anything else.
+std::future<int64_t> StartClient(const ClientOptions &opt, int i, std::vector<int> *applied,
+                             const std::vector<ycsbc::DB *> &dbs, const std::vector<bool> &db_ready,
+                             bool cleanup_db, ycsbc::CoreWorkload *wl, ycsbc::utils::OpBudget *budget,
+                             bool is_loading, ycsbc::ClientSync *sync, ycsbc::utils::RateLimiter *rlim,
+                             bool open_loop, std::function<void()> thread_init = nullptr) {
+  if (opt.inflight > 1) {
+    auto client = [thread_init](auto... args) {
+      if (thread_init) {
+        thread_init();
+      }
+      return ycsbc::CoroutineClientThread(args...);
+    };
+    return PinnedAsync(opt.placement[i], applied, client, dbs[i], wl, budget, is_loading,
+                       !db_ready[i], cleanup_db, sync, rlim, open_loop, opt.inflight);
+  }
+  auto client = [thread_init](auto... args) {
+    if (thread_init) {
+      thread_init();
+    }
+    return ycsbc::ClientThread(args...);
+  };
+  return PinnedAsync(opt.placement[i], applied, client, dbs[i], wl, budget, is_loading, false, false,
+                     !db_ready[i], cleanup_db, sync, rlim, open_loop, static_cast<bool *>(nullptr));
+}
+
+// waits until all client threads initialized and returns the time it took
+double AwaitInit(ycsbc::ClientSync *sync, ycsbc::utils::Timer<double> *timer) {
+  sync->ready.Await();
+  double init_time = timer->End();
+  timer->Start();
+  return init_time;
+}
+
+void PrintPlacement(const std::string &prefix, const std::vector<std::vector<int>> &applied) {
+  bool pinned = false;
+  for (auto &cpus : applied) {
+    pinned |= !cpus.empty();
+  }
+  if (!pinned) {
+    return;
+  }
+  std::cout << prefix << " placement(cpus):";
+  for (auto &cpus : applied) {
+    std::cout << " [" << (cpus.empty() ? "any" : ycsbc::utils::FormatCpuList(cpus)) << "]";
+  }
+  std::cout << std::endl;
+}
+
+// compression achieved by the engine on the loaded records, for valuecompressibility
+void PrintCompression(const std::string &prefix, const std::vector<ycsbc::DB *> &dbs,
+                      const std::vector<bool> &db_ready) {
+  uint64_t raw_bytes, stored_bytes;
+  if (dbs.empty() || !db_ready[0] || !dbs[0]->GetCompressionStats(&raw_bytes, &stored_bytes)) {
+    std::cout << prefix << " compression ratio: not reported by the DB" << std::endl;
+    return;
+  }
+  std::cout << prefix << " compression ratio: " << static_cast<double>(raw_bytes) / stored_bytes
+            << " (raw bytes " << raw_bytes << ", stored bytes " << stored_bytes << ")" << std::endl;
+}
+
+// throughput is taken over the window in which all client threads were running,
+// unless threads barely overlapped (e.g. more threads than cpus on a short run)
+void PrintThroughput(const std::string &prefix, int64_t ops, double runtime, const ycsbc::utils::OpBudget &budget) {
+  std::cout << prefix << " runtime(sec): " << runtime << std::endl;
+  std::cout << prefix << " operations(ops): " << ops << std::endl;
+  if (budget.HasWindow()) {
+    std::cout << prefix << " active window(sec): " << budget.WindowSeconds() << std::endl;
+  }
+  if (budget.HasWindow() && budget.WindowSeconds() >= runtime / 2) {
+    std::cout << prefix << " throughput(ops/sec): " << budget.WindowOps() / budget.WindowSeconds() << std::endl;
+  } else {
+    std::cout << prefix << " throughput(ops/sec): " << ops / runtime << std::endl;
+  }
+}
+
+// names in the comma separated list of property key
+std::vector<std::string> NameList(const ycsbc::utils::Properties &props, const std::string &key) {
+  std::vector<std::string> names;
+  std::istringstream input(props.GetProperty(key));
+  std::string name;
+  while (std::getline(input, name, ',')) {
+    name = ycsbc::utils::Trim(name);
+    if (!name.empty()) {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+// properties of thread group name, "group.<name>.threads" sets its threadcount
+ycsbc::utils::Properties GroupProperties(const ycsbc::utils::Properties &props, const std::string &name) {
+  ycsbc::utils::Properties group_props = props.Scoped("group." + name + ".");
+  group_props.SetProperty("threadcount", props.GetProperty("group." + name + ".threads",
+                                                            group_props.GetProperty("threadcount", "1")));
+  return group_props;
+}
+
+// client threads of a phase, summed over its thread groups if it has any
+int ClientThreadCount(const ycsbc::utils::Properties &props) {
+  if (!props.ContainsKey("groups")) {
+    return ReadClientOptions(props).threads;
+  }
+  int threads = 0;
+  for (const std::string &name : NameList(props, "groups")) {
+    threads += ReadClientOptions(GroupProperties(props, name)).threads;
+  }
+  return threads;
+}
+
+// Searches the highest target rate whose latency at slo.percentile stays within slo.latency_us
+// while the achieved throughput keeps up with the target. Every probed rate is measured for
+// slo.window seconds after slo.settle seconds. slo.search=step raises the rate by slo.step from
+// slo.start until the bound is violated, slo.search=binary bisects [0, slo.max] down to
+// slo.precision. Prints the latency-throughput curve of all probed rates.
+void RunSloSearch(const std::string &label, const ycsbc::utils::Properties &props,
+                  const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+                  ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements) {
+  const std::string mode = props.GetProperty("slo.search");
+  const double percentile = std::stod(props.GetProperty("slo.percentile", "99"));
+  const double latency_bound = std::stod(props.GetProperty("slo.latency_us", "0"));
+  const int64_t start_rate = std::stoll(props.GetProperty("slo.start", "1000"));
+  const int64_t step = std::stoll(props.GetProperty("slo.step", std::to_string(start_rate)));
+  const int64_t max_rate = std::stoll(props.GetProperty("slo.max", "0"));
+  const int64_t precision = std::stoll(props.GetProperty("slo.precision", std::to_string(max_rate / 100)));
+  // achieved throughput below this fraction of the target means the DB is saturated
+  const double min_ratio = std::stod(props.GetProperty("slo.min_ratio", "0.95"));
+  const std::chrono::duration<double> settle(std::stod(props.GetProperty("slo.settle", "2")));
+  const std::chrono::duration<double> window(std::stod(props.GetProperty("slo.window", "10")));
+  const bool open_loop = ycsbc::utils::StrToBool(props.GetProperty("limit.openloop", "false"));
+  if (mode != "step" && mode != "binary") {
+    std::cerr << "slo.search must be step or binary" << std::endl;
+    exit(1);
+  }
+  if (latency_bound <= 0 || start_rate <= 0 || step <= 0 || (mode == "binary" && max_rate <= 0)) {
+    std::cerr << "slo.search requires slo.latency_us, positive slo.start and slo.step, "
+                 "and slo.max for binary search" << std::endl;
+    exit(1);
+  }
+  uint64_t count, latency;
+  if (!measurements->GetLatencySummary(percentile, open_loop, nullptr, &count, &latency)) {
+    std::cerr << "slo.search requires measurementtype=hdrhistogram" << std::endl;
+    exit(1);
+  }
+
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = opt.threads;
+  int64_t rate = mode == "step" ? start_rate : std::max<int64_t>((max_rate + 1) / 2, 1);
+
+  ycsbc::ClientSync sync(num_threads);
+  ycsbc::utils::OpBudget budget(num_threads, ycsbc::utils::OpBudget::kUnlimited, 0, opt.op_chunk);
+  std::vector<std::future<int64_t>> client_threads;
+  std::vector<std::vector<int>> applied(num_threads);
+  ycsbc::utils::RateLimiter *rlim = NewRateLimiter(props, rate);
+  for (int i = 0; i < num_threads; ++i) {
+    client_threads.emplace_back(StartClient(opt, i, &applied[i], dbs, *db_ready, cleanup_db, wl, &budget,
+                                            false, &sync, rlim, open_loop));
+  }
+  sync.ready.Await();
+  budget.Start();
+  sync.start.CountDown();
+
+  struct Point {
+    int64_t target;
+    double throughput;
+    double latency_us;
+    bool pass;
+  };
+  std::vector<Point> curve;
+  int64_t best = 0;
+  int64_t lo = 0, hi = max_rate;
+  while (true) {
+    // a new schedule at the probed rate, with bursts of up to one second as for limit.ops
+    rlim->SetRate(rate);
+    rlim->SetBurst(rate);
+    rlim->Reset();
+    std::this_thread::sleep_for(settle);
+    // the window is the difference of two snapshots, resetting the histograms would race
+    // with the client threads recording into them
+    std::unique_ptr<ycsbc::Measurements::Snapshot> window_start = measurements->TakeSnapshot();
+    ycsbc::utils::Timer<double> timer;
+    timer.Start();
+    std::this_thread::sleep_for(window);
+    measurements->GetLatencySummary(percentile, open_loop, window_start.get(), &count, &latency);
+    double elapsed = timer.End();
+
+    Point point{rate, count / elapsed, latency / 1000.0, false};
+    point.pass = point.latency_us <= latency_bound && point.throughput >= min_ratio * rate;
+    curve.push_back(point);
+    std::cout << label << " SLO step " << curve.size() << ": target(ops/sec)=" << rate
+              << " throughput(ops/sec)=" << point.throughput << " p" << percentile << "(us)=" << point.latency_us
+              << (point.pass ? " pass" : " fail") << std::endl;
+    if (point.pass) {
+      best = std::max(best, rate);
+    }
+
+    if (mode == "step") {
+      if (!point.pass || (max_rate > 0 && rate + step > max_rate)) {
+        break;
+      }
+      rate += step;
+    } else {
+      (point.pass ? lo : hi) = rate;
+      if (hi - lo <= std::max<int64_t>(precision, 1)) {
+        break;
+      }
+      rate = lo + (hi - lo) / 2;
+    }
+  }
+
+  budget.Stop();
+  sync.finished.Await();
+  int64_t sum = 0;
+  for (auto &n : client_threads) {
+    sum += n.get();
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    (*db_ready)[i] = !cleanup_db;
+  }
+
+  std::sort(curve.begin(), curve.end(), [](const Point &a, const Point &b) { return a.target < b.target; });
+  std::cout << label << " SLO curve: target(ops/sec), throughput(ops/sec), p" << percentile << "(us)" << std::endl;
+  for (const Point &point : curve) {
+    std::cout << label << " SLO curve: " << point.target << ", " << point.throughput << ", " << point.latency_us
+              << std::endl;
+  }
+  std::cout << label << " operations(ops): " << sum << std::endl;
+  std::cout << label << " SLO max throughput(ops/sec): " << best << std::endl;
+  PrintPacing(label, rlim, 0, 0);
+  PrintPlacement(label, applied);
+  delete rlim;
+}
+
+// Runs the thread groups of the comma separated groups property side by side. Properties
+// "group.<name>.<key>" override "<key>" in group <name>, so each group has its own thread
+// count, workload mix, operation count and rate limit. The groups share the key space of wl,
+// report their own measurements, and the global measurements aggregate all groups.
+void RunGroups(const std::string &label, const ycsbc::utils::Properties &props,
+               const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+               ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements) {
+  struct Group {
+    std::string label;
+    ycsbc::utils::Properties props;
+    ClientOptions opt;
+    ycsbc::CoreWorkload wl;
+    RateOptions rate;
+    std::unique_ptr<ycsbc::Measurements> measurements;
+    std::unique_ptr<ycsbc::utils::OpBudget> budget;
+    std::unique_ptr<ycsbc::utils::RateLimiter> rlim;
+    // first DB of the group
+    int offset;
+    std::vector<std::future<int64_t>> threads;
+    std::vector<std::vector<int>> applied;
+    std::future<void> rlim_future;
+    int64_t sum = 0;
+  };
+
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = ClientThreadCount(props);
+  ycsbc::ClientSync sync(num_threads);
+  ycsbc::utils::Timer<double> timer;
+  std::vector<std::unique_ptr<Group>> groups;
+  int offset = 0;
+  for (const std::string &name : NameList(props, "groups")) {
+    auto group = std::make_unique<Group>();
+    group->label = label + " " + name;
+    group->props = GroupProperties(props, name);
+    group->opt = ReadClientOptions(group->props);
+    group->wl.ShareKeySpace(*wl);
+    group->wl.Init(group->props);
+    group->rate = ReadRateOptions(group->props, group->wl);
+    group->measurements.reset(ycsbc::CreateMeasurements(&group->props));
+    group->budget = std::make_unique<ycsbc::utils::OpBudget>(
+        group->opt.threads, TransactionCount(group->props, group->opt), group->opt.max_execution_time,
+        group->opt.op_chunk);
+    if (group->rate.Limited()) {
+      group->rlim.reset(NewRateLimiter(group->props, group->rate.ops_limit));
+    }
+    group->offset = offset;
+    group->applied.resize(group->opt.threads);
+    offset += group->opt.threads;
+    groups.push_back(std::move(group));
+  }
+
+  timer.Start();
+  for (auto &group : groups) {
+    const std::vector<ycsbc::DB *> group_dbs(dbs.begin() + group->offset,
+                                             dbs.begin() + group->offset + group->opt.threads);
+    const std::vector<bool> group_ready(db_ready->begin() + group->offset,
+                                        db_ready->begin() + group->offset + group->opt.threads);
+    ycsbc::Measurements *group_measurements = group->measurements.get();
+    auto thread_init = [group_measurements]() {
+      ycsbc::Measurements::SetThreadMeasurements(group_measurements);
+    };
+    for (int i = 0; i < group->opt.threads; ++i) {
+      group->threads.emplace_back(StartClient(group->opt, i, &group->applied[i], group_dbs, group_ready, cleanup_db,
+                                              &group->wl, group->budget.get(), false, &sync, group->rlim.get(),
+                                              group->rate.open_loop, thread_init));
+    }
+  }
+
+  double init_time = AwaitInit(&sync, &timer);
+  for (auto &group : groups) {
+    group->wl.ResetOpPacing();
+    group->budget->Start();
+    if (group->rate.rate_file != "") {
+      group->rlim_future = std::async(std::launch::async, RateLimitThread, group->rate.rate_file,
+                                      group->rlim.get(), &sync.finished);
+    }
+  }
+  std::future<void> status_future;
+  if (opt.show_status) {
+    status_future = std::async(std::launch::async, StatusThread, measurements, &sync.finished, opt.status_interval);
+  }
+  sync.start.CountDown();
+
+  sync.finished.Await();
+  double runtime = timer.End();
+
+  timer.Start();
+  int64_t sum = 0;
+  for (auto &group : groups) {
+    for (auto &n : group->threads) {
+      group->sum += n.get();
+    }
+    sum += group->sum;
+  }
+  double cleanup_time = timer.End();
+
+  if (opt.show_status) {
+    status_future.wait();
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    (*db_ready)[i] = !cleanup_db;
+  }
+
+  std::cout << label << " init time(sec): " << init_time << std::endl;
+  std::cout << label << " cleanup time(sec): " << cleanup_time << std::endl;
+  for (auto &group : groups) {
+    if (group->rate.rate_file != "") {
+      group->rlim_future.wait();
+    }
+    // a group's runtime ends when its last thread is done
+    const double group_runtime = group->budget->ElapsedSeconds();
+    PrintThroughput(group->label, group->sum, group_runtime, *group->budget);
+    PrintPacing(group->label, group->rlim.get(), group->rate.rate_file == "" ? group->rate.ops_limit : 0,
+                group->sum / group_runtime);
+    PrintOpPacing(group->label, group->wl, group_runtime);
+    PrintPlacement(group->label, group->applied);
+    std::cout << group->label << " measurements: " << group->measurements->GetStatusMsg() << std::endl;
+  }
+  std::cout << label << " runtime(sec): " << runtime << std::endl;
+  std::cout << label << " operations(ops): " << sum << std::endl;
+  std::cout << label << " throughput(ops/sec): " << sum / runtime << std::endl;
+}
+
+// Runs one client thread per shard of a trace until it has replayed shard_ops[i] operations.
+// thread_init(i) prepares thread i to replay shard i, and *start is set when the replay starts.
+void RunShards(const std::string &label, const ycsbc::utils::Properties &props, const std::vector<int64_t> &shard_ops,
+               const std::function<void(int)> &thread_init, std::chrono::steady_clock::time_point *start,
+               const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+               ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements) {
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = opt.threads;
+
+  // each thread has its own budget so it replays exactly its shard
+  ycsbc::ClientSync sync(num_threads);
+  ycsbc::utils::Timer<double> timer;
+  std::vector<std::unique_ptr<ycsbc::utils::OpBudget>> budgets;
+  std::vector<std::future<int64_t>> client_threads;
+  std::vector<std::vector<int>> applied(num_threads);
+  timer.Start();
+  for (int i = 0; i < num_threads; ++i) {
+    budgets.emplace_back(new ycsbc::utils::OpBudget(1, shard_ops[i], opt.max_execution_time, opt.op_chunk));
+    client_threads.emplace_back(StartClient(opt, i, &applied[i], dbs, *db_ready, cleanup_db, wl, budgets[i].get(),
+                                            false, &sync, nullptr, false, [&thread_init, i]() { thread_init(i); }));
+  }
+
+  double init_time = AwaitInit(&sync, &timer);
+  for (auto &budget : budgets) {
+    budget->Start();
+  }
+  std::future<void> status_future;
+  if (opt.show_status) {
+    status_future = std::async(std::launch::async, StatusThread,
+                               measurements, &sync.finished, opt.status_interval);
+  }
+  *start = std::chrono::steady_clock::now();
+  sync.start.CountDown();
+
+  sync.finished.Await();
+  double runtime = timer.End();
+
+  int64_t sum = 0;
+  for (auto &n : client_threads) {
+    assert(n.valid());
+    sum += n.get();
+  }
+  if (opt.show_status) {
+    status_future.wait();
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    (*db_ready)[i] = !cleanup_db;
+  }
+
+  int64_t total_ops = 0;
+  for (int64_t ops : shard_ops) {
+    total_ops += ops;
+  }
+  std::cout << label << " init time(sec): " << init_time << std::endl;
+  std::cout << label << " runtime(sec): " << runtime << std::endl;
+  std::cout << label << " operations(ops): " << sum << " of " << total_ops << " in trace" << std::endl;
+  std::cout << label << " throughput(ops/sec): " << sum / runtime << std::endl;
+  PrintPlacement(label, applied);
+}
+
+// Replays the trace file in property replay instead of generating transactions. The trace is
+// sharded by key over the client threads, so the operations on a key keep their order, and
+// each operation is issued at its recorded time divided by replay.speed (0: back to back).
+void RunReplay(const std::string &label, const ycsbc::utils::Properties &props,
+               const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+               ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements) {
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = opt.threads;
+  const std::string file = props["replay"];
+  const double speed = std::stod(props.GetProperty("replay.speed", "1"));
+  const int64_t spin_ns = std::stoll(props.GetProperty("limit.spin_us", "100")) * 1000;
+  if (speed < 0) {
+    std::cerr << "replay.speed must not be negative" << std::endl;
+    exit(1);
+  }
+  // a timed replay waits for each operation on the thread, which would stall the other
+  // coroutines of the thread, and these would take operations of the shard out of order
+  if (speed > 0 && opt.inflight > 1) {
+    std::cerr << "replay.speed > 0 requires client.inflight=1" << std::endl;
+    exit(1);
+  }
+
+  std::chrono::steady_clock::time_point start;
+  std::vector<int64_t> shard_ops;
+  std::vector<std::unique_ptr<ycsbc::TraceReplay>> replays;
+  try {
+    shard_ops = ycsbc::TraceReader::CountShards(file, num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      replays.emplace_back(new ycsbc::TraceReplay{ycsbc::TraceReader(file, i, num_threads), &start, speed,
+                                                  spin_ns});
+    }
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << e.what() << std::endl;
+    exit(1);
+  }
+
+  auto thread_init = [&replays](int i) {
+    ycsbc::CoreWorkload::SetThreadReplay(replays[i].get());
+  };
+  RunShards(label, props, shard_ops, thread_init, &start, dbs, db_ready, cleanup_db, wl, measurements);
+}
+
+// Generates the operations of a transaction phase before it starts, in parallel on the cpus of
+// the client threads, and then runs them back to back. Throughput then excludes the cost of
+// choosing operations and keys, giving an upper bound of what the DB sustains.
+void RunPregenerated(const std::string &label, const ycsbc::utils::Properties &props,
+                     const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+                     ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements) {
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = opt.threads;
+  const int64_t total_ops = TransactionCount(props, opt);
+  if (total_ops == ycsbc::utils::OpBudget::kUnlimited) {
+    std::cerr << "pregenerate requires operationcount" << std::endl;
+    exit(1);
+  }
+  if (ReadRateOptions(props, *wl).Limited() || wl->HasOpLimits() || props.ContainsKey("record")) {
+    std::cerr << "pregenerate cannot be combined with rate limits or -record" << std::endl;
+    exit(1);
+  }
+  std::vector<int64_t> shard_ops(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    shard_ops[i] = total_ops / num_threads + (i < total_ops % num_threads ? 1 : 0);
+  }
+
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  std::unique_ptr<ycsbc::OpStream> stream;
+  try {
+    stream.reset(new ycsbc::OpStream(shard_ops, wl->MaxTraceRecords()));
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << e.what() << std::endl;
+    exit(1);
+  }
+  wl->SetTrace(stream.get());
+  std::vector<std::future<int64_t>> generators;
+  std::vector<std::vector<int>> applied(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    ycsbc::OpStream *segments = stream.get();
+    auto generate = [segments, wl, i, ops = shard_ops[i]]() {
+      ycsbc::NullDB db;
+      try {
+        segments->SetThreadSegment(i);
+        for (int64_t n = 0; n < ops; ++n) {
+          wl->DoTransaction(db);
+        }
+      } catch (const ycsbc::utils::Exception &e) {
+        std::cerr << "Caught exception: " << e.what() << std::endl;
+        exit(1);
+      }
+      return 0;
+    };
+    generators.emplace_back(PinnedAsync(opt.placement[i], &applied[i], generate));
+  }
+  for (auto &generator : generators) {
+    generator.get();
+  }
+  wl->SetTrace(nullptr);
+  std::cout << label << " pregenerate time(sec): " << timer.End() << std::endl;
+  std::cout << label << " pregenerated(MB): " << stream->Bytes() / 1048576.0 << std::endl;
+
+  std::chrono::steady_clock::time_point start;
+  std::vector<std::unique_ptr<ycsbc::TraceReplay>> replays;
+  for (int i = 0; i < num_threads; ++i) {
+    replays.emplace_back(new ycsbc::TraceReplay{ycsbc::TraceReader(stream->begin(i), stream->end(i)), &start, 0, 0});
+  }
+  auto thread_init = [&replays](int i) {
+    ycsbc::CoreWorkload::SetThreadReplay(replays[i].get());
+  };
+  RunShards(label, props, shard_ops, thread_init, &start, dbs, db_ready, cleanup_db, wl, measurements);
+}
+
+// Runs the operations of the external trace in property trace.file (see TraceWorkload), each
+// client thread replaying the operations on its share of the keys.
+void RunExternalTrace(const std::string &label, const ycsbc::utils::Properties &props,
+                      const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+                      ycsbc::Measurements *measurements) {
+  const int num_threads = ReadClientOptions(props).threads;
+  ycsbc::TraceWorkload wl;
+  std::vector<int64_t> shard_ops;
+  std::vector<std::unique_ptr<ycsbc::ExternalTraceCursor>> cursors;
+  try {
+    wl.Init(props);
+    shard_ops = wl.CountShards(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      cursors.push_back(wl.NewCursor(i, num_threads));
+    }
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << e.what() << std::endl;
+    exit(1);
+  }
+
+  std::chrono::steady_clock::time_point start;
+  wl.SetStart(&start);
+  auto thread_init = [&cursors](int i) {
+    ycsbc::TraceWorkload::SetThreadCursor(cursors[i].get());
+  };
+  RunShards(label, props, shard_ops, thread_init, &start, dbs, db_ready, cleanup_db, &wl, measurements);
+}
+
+// Loads the records with load.mode=bulk: each client thread generates the records of its own
+// key range in ascending key order and passes them to DB::BulkInsert in batches, so engines
+// can ingest them without their regular write path.
+void RunBulkLoad(const std::string &label, const ycsbc::utils::Properties &props,
+                 const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+                 ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements) {
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = opt.threads;
+  wl->PlanBulkLoad(num_threads);
+
+  ycsbc::ClientSync sync(num_threads);
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  std::vector<std::future<int64_t>> client_threads;
+  std::vector<std::vector<int>> applied(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    auto load = [db = dbs[i], init_db = !(*db_ready)[i], cleanup_db, wl, &sync, i]() {
+      try {
+        if (init_db) {
+          db->Init();
+        }
+        sync.ready.CountDown();
+        sync.start.Await();
+        int64_t inserted = wl->DoBulkLoad(*db, i);
+        sync.finished.CountDown();
+        if (cleanup_db) {
+          db->Cleanup();
+        }
+        return inserted;
+      } catch (const ycsbc::utils::Exception &e) {
+        std::cerr << "Caught exception: " << e.what() << std::endl;
+        exit(1);
+      }
+    };
+    client_threads.emplace_back(PinnedAsync(opt.placement[i], &applied[i], load));
+  }
+
+  double init_time = AwaitInit(&sync, &timer);
+  std::future<void> status_future;
+  if (opt.show_status) {
+    status_future = std::async(std::launch::async, StatusThread,
+                               measurements, &sync.finished, opt.status_interval);
+  }
+  sync.start.CountDown();
+
+  sync.finished.Await();
+  double runtime = timer.End();
+
+  int64_t sum = 0;
+  for (auto &n : client_threads) {
+    assert(n.valid());
+    sum += n.get();
+  }
+  if (opt.show_status) {
+    status_future.wait();
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    (*db_ready)[i] = !cleanup_db;
+  }
+
+  std::cout << label << " init time(sec): " << init_time << std::endl;
+  std::cout << label << " runtime(sec): " << runtime << std::endl;
+  std::cout << label << " operations(ops): " << sum << std::endl;
+  std::cout << label << " throughput(ops/sec): " << sum / runtime << std::endl;
+  PrintPlacement(label, applied);
+}
+
+// Runs a load or transaction phase with threadcount client threads.
+void RunClients(const std::string &label, const ycsbc::utils::Properties &props, bool is_loading,
+                const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+                ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements) {
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = opt.threads;
+
+  int64_t total_ops;
+  RateOptions rate{0, "", false};
+  if (is_loading) {
+    total_ops = std::stoll(props[ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY]);
+  } else {
+    rate = ReadRateOptions(props, *wl);
+    total_ops = TransactionCount(props, opt);
+  }
+
+  ycsbc::ClientSync sync(num_threads);
+  ycsbc::utils::Timer<double> timer;
+  ycsbc::utils::OpBudget budget(num_threads, total_ops, opt.max_execution_time, opt.op_chunk);
+
+  timer.Start();
+  std::vector<std::future<int64_t>> client_threads;
+  std::vector<std::vector<int>> applied(num_threads);
+  ycsbc::utils::RateLimiter *rlim = rate.Limited() ? NewRateLimiter(props, rate.ops_limit) : nullptr;
+  for (int i = 0; i < num_threads; ++i) {
+    client_threads.emplace_back(StartClient(opt, i, &applied[i], dbs, *db_ready, cleanup_db, wl, &budget,
+                                            is_loading, &sync, rlim, rate.open_loop));
+  }
+  assert((int)client_threads.size() == num_threads);
+
+  double init_time = AwaitInit(&sync, &timer);
+  wl->ResetOpPacing();
+  budget.Start();
+  std::future<void> status_future;
+  if (opt.show_status) {
+    status_future = std::async(std::launch::async, StatusThread,
+                               measurements, &sync.finished, opt.status_interval);
+  }
+  std::future<void> rlim_future;
+  if (rate.rate_file != "") {
+    rlim_future = std::async(std::launch::async, RateLimitThread, rate.rate_file, rlim, &sync.finished);
+  }
+  sync.start.CountDown();
+
+  sync.finished.Await();
+  double runtime = timer.End();
+
+  timer.Start();
+  int64_t sum = 0;
+  for (auto &n : client_threads) {
+    assert(n.valid());
+    sum += n.get();
+  }
+  double cleanup_time = timer.End();
+
+  if (opt.show_status) {
+    status_future.wait();
+  }
+  if (rate.rate_file != "") {
+    rlim_future.wait();
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    (*db_ready)[i] = !cleanup_db;
+  }
+
+  std::cout << label << " init time(sec): " << init_time << std::endl;
+  std::cout << label << " cleanup time(sec): " << cleanup_time << std::endl;
+  PrintThroughput(label, sum, runtime, budget);
+  PrintPacing(label, rlim, rate.rate_file == "" ? rate.ops_limit : 0, sum / runtime);
+  if (!is_loading) {
+    PrintOpPacing(label, *wl, runtime);
+  }
+  PrintPlacement(label, applied);
+  delete rlim;
+}
+
+// Runs a load or transaction phase on the first threadcount DBs. A DB that is not ready is
+// initialized by its client thread, and DBs are cleaned up afterwards if cleanup_db.
+// Transactions generated by wl are recorded to the trace file in property record, if set.
+void RunPhase(const std::string &label, const ycsbc::utils::Properties &props, bool is_loading,
+              const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready, bool cleanup_db,
+              ycsbc::CoreWorkload *wl, ycsbc::Measurements *measurements) {
+  if (!is_loading && props.ContainsKey("replay")) {
+    RunReplay(label, props, dbs, db_ready, cleanup_db, wl, measurements);
+    return;
+  }
+  if (!is_loading && props.ContainsKey(ycsbc::TraceWorkload::TRACE_FILE_PROPERTY)) {
+    RunExternalTrace(label, props, dbs, db_ready, cleanup_db, measurements);
+    return;
+  }
+  std::unique_ptr<ycsbc::TraceWriter> trace;
+  if (!is_loading && props.ContainsKey("record")) {
+    try {
+      trace.reset(new ycsbc::TraceWriter(props["record"]));
+    } catch (const ycsbc::utils::Exception &e) {
+      std::cerr << e.what() << std::endl;
+      exit(1);
+    }
+    wl->SetTrace(trace.get());
+  }
+
+  if (is_loading && props.GetProperty("load.mode", "normal") == "bulk") {
+    RunBulkLoad(label, props, dbs, db_ready, cleanup_db, wl, measurements);
+  } else if (!is_loading && props.ContainsKey("slo.search")) {
+    RunSloSearch(label, props, dbs, db_ready, cleanup_db, wl, measurements);
+  } else if (!is_loading && props.GetProperty("pregenerate", "false") == "true") {
+    RunPregenerated(label, props, dbs, db_ready, cleanup_db, wl, measurements);
+  } else if (!is_loading && props.ContainsKey("groups")) {
+    RunGroups(label, props, dbs, db_ready, cleanup_db, wl, measurements);
+  } else {
+    RunClients(label, props, is_loading, dbs, db_ready, cleanup_db, wl, measurements);
+  }
+
+  if (trace) {
+    wl->SetTrace(nullptr);
+    try {
+      trace->Close();
+    } catch (const ycsbc::utils::Exception &e) {
+      std::cerr << e.what() << std::endl;
+      exit(1);
+    }
+  }
+}
+
+// percentage by which value differs from prev
+double RelativeChange(double value, double prev) {
+  return prev == 0 ? (value == 0 ? 0 : 100) : std::abs(value - prev) / prev * 100;
+}
+
+// Runs transactions until warmup.ops or warmup.time are used up or, with warmup.converge
+// set, until throughput and engine cache hit ratio change by at most that many percent
+// between two warmup.interval periods. Returns false if no warmup is configured.
+bool Warmup(const std::string &label, const ycsbc::utils::Properties &props, const std::vector<ycsbc::DB *> &dbs,
+            std::vector<bool> *db_ready, ycsbc::CoreWorkload *wl) {
+  int64_t warmup_ops = std::stoll(props.GetProperty("warmup.ops", "0"));
+  const double warmup_time = std::stod(props.GetProperty("warmup.time", "0"));
+  const double converge = std::stod(props.GetProperty("warmup.converge", "0"));
+  const int interval = std::stoi(props.GetProperty("warmup.interval", "1"));
+  if (warmup_ops <= 0 && warmup_time <= 0 && converge <= 0) {
+    return false;
+  }
+  if (warmup_ops <= 0) {
+    warmup_ops = ycsbc::utils::OpBudget::kUnlimited;
+  }
+  if (interval < 1) {
+    std::cerr << "warmup.interval must be at least 1" << std::endl;
+    exit(1);
+  }
+
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = opt.threads;
+  ycsbc::ClientSync sync(num_threads);
+  ycsbc::utils::Timer<double> timer;
+  ycsbc::utils::OpBudget budget(num_threads, warmup_ops, warmup_time, opt.op_chunk);
+
+  std::vector<std::future<int64_t>> client_threads;
+  std::vector<std::vector<int>> applied(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    client_threads.emplace_back(StartClient(opt, i, &applied[i], dbs, *db_ready, false, wl, &budget, false,
+                                            &sync, nullptr, false));
+  }
+
+  sync.ready.Await();
+  timer.Start();
+  budget.Start();
+  sync.start.CountDown();
+
+  int64_t last_ops = 0;
+  uint64_t last_hits = 0, last_misses = 0;
+  double last_throughput = -1, last_hit_ratio = -1;
+  int intervals = 0;
+  bool converged = false;
+  while (!sync.finished.AwaitFor(interval)) {
+    if (converge <= 0 || converged) {
+      continue;
+    }
+    intervals++;
+    int64_t ops = budget.DoneOps();
+    double throughput = static_cast<double>(ops - last_ops) / interval;
+    double hit_ratio = -1;
+    uint64_t hits, misses;
+    if (dbs[0]->GetCacheStats(&hits, &misses) && hits + misses > last_hits + last_misses) {
+      hit_ratio = static_cast<double>(hits - last_hits) / (hits + misses - last_hits - last_misses);
+      last_hits = hits;
+      last_misses = misses;
+    }
+    std::cout << label << " interval " << intervals << " throughput(ops/sec): " << throughput;
+    if (hit_ratio >= 0) {
+      std::cout << " cache hit ratio: " << hit_ratio;
+    }
+    std::cout << std::endl;
+
+    converged = last_throughput >= 0 && RelativeChange(throughput, last_throughput) <= converge &&
+                (hit_ratio < 0 || (last_hit_ratio >= 0 && RelativeChange(hit_ratio, last_hit_ratio) <= converge));
+    last_ops = ops;
+    last_throughput = throughput;
+    last_hit_ratio = hit_ratio;
+    if (converged) {
+      budget.Stop();
+    }
+  }
+  double runtime = timer.End();
+
+  int64_t sum = 0;
+  for (auto &n : client_threads) {
+    sum += n.get();
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    (*db_ready)[i] = true;
+  }
+
+  std::cout << label << " runtime(sec): " << runtime << std::endl;
+  std::cout << label << " operations(ops): " << sum << std::endl;
+  if (converge > 0) {
+    std::cout << label << " converged: " << (converged ? "true" : "false") << std::endl;
+  }
+  return true;
+}
+
+
+// Runs the comma separated phase list of the phases property on DBs kept open across phases.
+// Properties "phase.<name>.<key>" override "<key>" in phase <name>, whose type is load, warmup
+// or run (default: load for "load", warmup for names starting with "warm", run otherwise).
+// Each phase has its own workload and reports its own measurements.
+void RunPhases(const ycsbc::utils::Properties &props, const std::vector<ycsbc::DB *> &dbs,
+               ycsbc::Measurements *measurements) {
+  std::vector<bool> db_ready(dbs.size(), false);
+  std::string record_count = props.GetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY);
+  for (const std::string &name : NameList(props, "phases")) {
+    const std::string prefix = "phase." + name + ".";
+    ycsbc::utils::Properties phase_props = props.Scoped(prefix);
+    // keys inserted by earlier phases stay in the key space
+    if (!props.ContainsKey(prefix + ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY)) {
+      phase_props.SetProperty(ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY, record_count);
+    }
+    const std::string type = props.GetProperty(prefix + "type", name == "load" ? "load" :
+                                               name.compare(0, 4, "warm") == 0 ? "warmup" : "run");
+
+    ycsbc::CoreWorkload wl;
+    wl.Init(phase_props);
+    measurements->Reset();
+    if (type == "load") {
+      RunPhase(name, phase_props, true, dbs, &db_ready, false, &wl, measurements);
+    } else if (type == "run") {
+      RunPhase(name, phase_props, false, dbs, &db_ready, false, &wl, measurements);
+      record_count = std::to_string(wl.RecordCount());
+    } else if (type == "warmup") {
+      if (!Warmup(name, phase_props, dbs, &db_ready, &wl)) {
+        std::cerr << "Phase " << name << " needs warmup.ops, warmup.time or warmup.converge" << std::endl;
+        exit(1);
+      }
+      record_count = std::to_string(wl.RecordCount());
+      continue;
+    } else {
+      std::cerr << "Unknown type of phase " << name << ": " << type << std::endl;
+      exit(1);
+    }
+    std::cout << name << " measurements: " << measurements->GetStatusMsg() << std::endl;
+  }
+
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  for (size_t i = 0; i < dbs.size(); i++) {
+    if (db_ready[i]) {
+      dbs[i]->Cleanup();
     }
   }
+  std::cout << "Cleanup time(sec): " << timer.End() << std::endl;
+}
+
+// Replaces the DB with the snapshot in dir, before any DB is initialized.
+void RestoreSnapshot(const std::string &dir, const std::vector<ycsbc::DB *> &dbs) {
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  ycsbc::DB::Status s = ycsbc::DB::kError;
+  try {
+    s = dbs[0]->Restore(dir);
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << "Restore failed: " << e.what() << std::endl;
+    exit(1);
+  }
+  if (s != ycsbc::DB::kOK) {
+    std::cerr << (s == ycsbc::DB::kNotImplemented ? "DB does not support snapshots" : "Restore failed") << std::endl;
+    exit(1);
+  }
+  std::cout << "Restore time(sec): " << timer.End() << std::endl;
+}
+
+// Writes a snapshot of the DB to the new directory dir, initializing the first DB if the load
+// phase did not leave it open.
+void TakeSnapshot(const std::string &dir, const std::vector<ycsbc::DB *> &dbs, std::vector<bool> *db_ready) {
+  std::error_code ec;
+  if (std::filesystem::exists(dir, ec)) {
+    std::cerr << "Snapshot directory already exists: " << dir << std::endl;
+    exit(1);
+  }
+  ycsbc::utils::Timer<double> timer;
+  timer.Start();
+  ycsbc::DB::Status s = ycsbc::DB::kError;
+  try {
+    if (!(*db_ready)[0]) {
+      dbs[0]->Init();
+      (*db_ready)[0] = true;
+    }
+    s = dbs[0]->Snapshot(dir);
+  } catch (const ycsbc::utils::Exception &e) {
+    std::cerr << "Snapshot failed: " << e.what() << std::endl;
+    exit(1);
+  }
+  if (s != ycsbc::DB::kOK) {
+    std::cerr << (s == ycsbc::DB::kNotImplemented ? "DB does not support snapshots" : "Snapshot failed") << std::endl;
+    exit(1);
+  }
+  std::cout << "Snapshot time(sec): " << timer.End() << std::endl;
 }
 
 int main(const int argc, const char *argv[]) {
   ycsbc::utils::Properties props;
   ParseCommandLine(argc, argv, props);
 
+  const bool do_phases = props.ContainsKey("phases");
   const bool do_load = (props.GetProperty("doload", "false") == "true");
   const bool do_transaction = (props.GetProperty("dotransaction", "false") == "true");
   const bool do_htap = (props.GetProperty("dohtap", "false") == "true");
+  const bool do_snapshot = props.ContainsKey("snapshot");
   const int num_ap_threads = stoi(props.GetProperty("apthreadcount", "1"));
-  if (!do_load && !do_transaction && !do_htap) {
+  if (!do_phases && !do_load && !do_transaction && !do_htap && !do_snapshot) {
     std::cerr << "No operation to do" << std::endl;
     exit(1);
   }
@@ -101,6 +1204,10 @@ int main(const int argc, const char *argv[]) {
     std::cerr << "Cannot do both transaction and htap" << std::endl;
     exit(1);
   }
+  if (do_phases && (do_load || do_transaction || do_htap || do_snapshot)) {
+    std::cerr << "Cannot combine phases with -load, -run, -runhtap or -snapshot" << std::endl;
+    exit(1);
+  }
   // if (do_htap) {
   //   if(num_ap_threads < 1) {
   //     std::cerr << "HTAP need at least 1 ap thread" << std::endl;
@@ -108,7 +1215,16 @@ int main(const int argc, const char *argv[]) {
   //   }
   // }
 
-  const int num_threads = stoi(props.GetProperty("threadcount", "1"));
+  const ClientOptions opt = ReadClientOptions(props);
+  const int num_threads = opt.threads;
+
+  // one DB instance per client thread of the largest phase
+  int num_dbs = ClientThreadCount(props);
+  if (do_phases) {
+    for (const std::string &name : NameList(props, "phases")) {
+      num_dbs = std::max(num_dbs, ClientThreadCount(props.Scoped("phase." + name + ".")));
+    }
+  }
 
   ycsbc::Measurements *measurements = ycsbc::CreateMeasurements(&props);
   if (measurements == nullptr) {
@@ -117,7 +1233,7 @@ int main(const int argc, const char *argv[]) {
   }
 
   std::vector<ycsbc::DB *> dbs;
-  for (int i = 0; i < num_threads; i++) {
+  for (int i = 0; i < num_dbs; i++) {
     ycsbc::DB *db = ycsbc::DBFactory::CreateDB(&props, measurements);
     if (db == nullptr) {
       std::cerr << "Unknown database name " << props["dbname"] << std::endl;
@@ -125,133 +1241,74 @@ int main(const int argc, const char *argv[]) {
     }
     dbs.push_back(db);
   }
+  std::vector<bool> db_ready(num_dbs, false);
 
-  ycsbc::CoreWorkload wl;
+  if (props.ContainsKey("restore")) {
+    RestoreSnapshot(props["restore"], dbs);
+  }
 
-  wl.Init(props);
+  if (do_phases) {
+    RunPhases(props, dbs, measurements);
+  }
 
-  // print status periodically
-  const bool show_status = (props.GetProperty("status", "false") == "true");
+  ycsbc::CoreWorkload wl;
 
-  const int status_interval = std::stoi(props.GetProperty("status.interval", "10"));
+  if (!do_phases) {
+    wl.Init(props);
+  }
 
   // load phase
   if (do_load) {
-    const int total_ops = stoi(props[ycsbc::CoreWorkload::RECORD_COUNT_PROPERTY]);
-
-    ycsbc::utils::CountDownLatch latch(num_threads);
-    ycsbc::utils::Timer<double> timer;
-
-    timer.Start();
-    std::future<void> status_future;
-    if (show_status) {
-      status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
-    }
-    std::vector<std::future<int>> client_threads;
-    for (int i = 0; i < num_threads; ++i) {
-      int thread_ops = total_ops / num_threads;
-      if (i < total_ops % num_threads) {
-        thread_ops++;
+    const bool cleanup_db = !do_transaction && !do_htap && !do_snapshot;
+    // the DBs stay open until the compression achieved is known
+    const bool report_compression = props.ContainsKey(ycsbc::CoreWorkload::VALUE_COMPRESSIBILITY_PROPERTY);
+    RunPhase("Load", props, true, dbs, &db_ready, cleanup_db && !report_compression, &wl, measurements);
+    if (report_compression) {
+      PrintCompression("Load", dbs, db_ready);
+      for (size_t i = 0; cleanup_db && i < dbs.size(); i++) {
+        if (db_ready[i]) {
+          dbs[i]->Cleanup();
+          db_ready[i] = false;
+        }
       }
-
-      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, true, false, false, true, !do_transaction && !do_htap, &latch, nullptr, nullptr, nullptr));
-    }
-    assert((int)client_threads.size() == num_threads);
-
-    int sum = 0;
-    for (auto &n : client_threads) {
-      assert(n.valid());
-      sum += n.get();
     }
-    double runtime = timer.End();
+  }
 
-    if (show_status) {
-      status_future.wait();
+  if (do_snapshot) {
+    TakeSnapshot(props["snapshot"], dbs, &db_ready);
+    if (!do_transaction && !do_htap) {
+      for (size_t i = 0; i < dbs.size(); i++) {
+        if (db_ready[i]) {
+          dbs[i]->Cleanup();
+          db_ready[i] = false;
+        }
+      }
     }
-
-    std::cout << "Load runtime(sec): " << runtime << std::endl;
-    std::cout << "Load operations(ops): " << sum << std::endl;
-    std::cout << "Load throughput(ops/sec): " << sum / runtime << std::endl;
   }
 
   measurements->Reset();
   std::this_thread::sleep_for(std::chrono::seconds(stoi(props.GetProperty("sleepafterload", "0"))));
 
+  // warmup phase, its measurements are discarded
+  if ((do_transaction || do_htap) && Warmup("Warmup", props, dbs, &db_ready, &wl)) {
+    measurements->Reset();
+  }
 
   // transaction phase
   if (do_transaction) {
-    // initial ops per second, unlimited if <= 0
-    const int64_t ops_limit = std::stoi(props.GetProperty("limit.ops", "0"));
-    // rate file path for dynamic rate limiting, format "time_stamp_sec new_ops_per_second" per line
-    std::string rate_file = props.GetProperty("limit.file", "");
-
-    const int total_ops = stoi(props[ycsbc::CoreWorkload::OPERATION_COUNT_PROPERTY]);
-
-    ycsbc::utils::CountDownLatch latch(num_threads);
-    ycsbc::utils::Timer<double> timer;
-
-    timer.Start();
-    std::future<void> status_future;
-    if (show_status) {
-      status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
-    }
-    std::vector<std::future<int>> client_threads;
-    std::vector<ycsbc::utils::RateLimiter *> rate_limiters;
-    for (int i = 0; i < num_threads; ++i) {
-      int thread_ops = total_ops / num_threads;
-      if (i < total_ops % num_threads) {
-        thread_ops++;
-      }
-      ycsbc::utils::RateLimiter *rlim = nullptr;
-      if (ops_limit > 0 || rate_file != "") {
-        int64_t per_thread_ops = ops_limit / num_threads;
-        rlim = new ycsbc::utils::RateLimiter(per_thread_ops, per_thread_ops);
-      }
-      rate_limiters.push_back(rlim);
-      client_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, false, false, false, !do_load, true, &latch, rlim, nullptr, nullptr));
-    }
-
-    std::future<void> rlim_future;
-    if (rate_file != "") {
-      rlim_future = std::async(std::launch::async, RateLimitThread, rate_file, rate_limiters, &latch);
-    }
-
-    assert((int)client_threads.size() == num_threads);
-
-    int sum = 0;
-    for (auto &n : client_threads) {
-      assert(n.valid());
-      sum += n.get();
-    }
-    double runtime = timer.End();
-
-    if (show_status) {
-      status_future.wait();
-    }
-
-    std::cout << "Run runtime(sec): " << runtime << std::endl;
-    std::cout << "Run operations(ops): " << sum << std::endl;
-    std::cout << "Run throughput(ops/sec): " << sum / runtime << std::endl;
+    RunPhase("Run", props, false, dbs, &db_ready, true, &wl, measurements);
   }
 
-  
   // htap phase
   if (do_htap) {
-    // initial ops per second, unlimited if <= 0
-    const int64_t ops_limit = std::stoi(props.GetProperty("limit.ops", "0"));
-    // rate file path for dynamic rate limiting, format "time_stamp_sec new_ops_per_second" per line
-    std::string rate_file = props.GetProperty("limit.file", "");
+    const RateOptions rate = ReadRateOptions(props, wl);
 
-    const int total_ops = stoi(props[ycsbc::CoreWorkload::AP_COUNT_PROPERTY]);
+    const int64_t total_ops = std::stoll(props[ycsbc::CoreWorkload::AP_COUNT_PROPERTY]);
 
-    ycsbc::utils::CountDownLatch latch(num_threads + num_ap_threads);
+    ycsbc::ClientSync ap_sync(num_ap_threads);
+    ycsbc::ClientSync tp_sync(num_threads);
     ycsbc::utils::Timer<double> timer;
     bool ap_done = false;
-    bool* time_limit = nullptr;
     int htap_time = -1;
 
     if (props.ContainsKey("htaptime")) {
@@ -260,88 +1317,97 @@ int main(const int argc, const char *argv[]) {
         std::cerr << "Invalid htap time: " << htap_time << std::endl;
         exit(1);
       }
-      time_limit = new bool(false);
     }
 
+    // ap threads run for htaptime if set, tp threads until ap threads are done
+    ycsbc::utils::OpBudget ap_budget(num_ap_threads, htap_time > 0 ? ycsbc::utils::OpBudget::kUnlimited : total_ops,
+                                     htap_time > 0 ? htap_time : opt.max_execution_time, 1);
+    ycsbc::utils::OpBudget tp_budget(num_threads, ycsbc::utils::OpBudget::kUnlimited, opt.max_execution_time,
+                                     opt.op_chunk);
+
     timer.Start();
-    std::future<void> status_future;
-    if (show_status) {
-      status_future = std::async(std::launch::async, StatusThread,
-                                 measurements, &latch, status_interval);
-    }
-    std::vector<std::future<int>> client_ap_threads;
-    std::vector<std::future<int>> client_tp_threads;
-    std::vector<ycsbc::utils::RateLimiter *> rate_limiters;
+    std::vector<std::future<int64_t>> client_ap_threads;
+    std::vector<std::future<int64_t>> client_tp_threads;
+    ycsbc::utils::RateLimiter *rlim = rate.Limited() ? NewRateLimiter(props, rate.ops_limit) : nullptr;
+    // cpus usable by htap ap threads (default: same as client.cpuset)
+    const std::vector<std::vector<int>> ap_placement =
+        PlanPlacement(num_ap_threads, props.GetProperty("htap.ap_cpuset", props.GetProperty("client.cpuset", "")),
+                      props.GetProperty("client.numa_policy", "none"));
+    std::vector<std::vector<int>> ap_applied(num_ap_threads);
+    std::vector<std::vector<int>> tp_applied(num_threads);
     for (int i = 0; i < num_ap_threads; ++i) {
-      int thread_ops;
-      if (htap_time > 0)
-        thread_ops = INT_MAX;
-      else
-        thread_ops = total_ops / num_ap_threads;
-      if (i < total_ops % num_ap_threads) {
-        thread_ops++;
-      }
-      client_ap_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, false, true, true, !do_load, true, &latch, nullptr, nullptr, time_limit));
+      client_ap_threads.emplace_back(PinnedAsync(ap_placement[i], &ap_applied[i], ycsbc::ClientThread,
+                                                 dbs[i], &wl, &ap_budget, false, true, true, !db_ready[i], true,
+                                                 &ap_sync, nullptr, false, nullptr));
     }
     
     assert((int)client_ap_threads.size() == num_ap_threads);
 
     for (int i = 0; i < num_threads; ++i) {
-      int thread_ops = INT_MAX;
-      ycsbc::utils::RateLimiter *rlim = nullptr;
-      if (ops_limit > 0 || rate_file != "") {
-        int64_t per_thread_ops = ops_limit / num_threads;
-        rlim = new ycsbc::utils::RateLimiter(per_thread_ops, per_thread_ops);
-      }
-      rate_limiters.push_back(rlim);
-      client_tp_threads.emplace_back(std::async(std::launch::async, ycsbc::ClientThread, dbs[i], &wl,
-                                             thread_ops, false, true, false, !do_load, true, &latch, rlim, &ap_done, nullptr));
-    }
-
-    std::future<void> rlim_future;
-    if (rate_file != "") {
-      rlim_future = std::async(std::launch::async, RateLimitThread, rate_file, rate_limiters, &latch);
+      client_tp_threads.emplace_back(PinnedAsync(opt.placement[i], &tp_applied[i], ycsbc::ClientThread,
+                                                 dbs[i], &wl, &tp_budget, false, true, false, !db_ready[i], true,
+                                                 &tp_sync, rlim, rate.open_loop, &ap_done));
     }
 
     assert((int)client_tp_threads.size() == num_threads);
 
-    if (htap_time > 0) {
-      std::this_thread::sleep_for(std::chrono::seconds(htap_time));
-      *time_limit = true;
+    ap_sync.ready.Await();
+    double init_time = AwaitInit(&tp_sync, &timer);
+    ap_budget.Start();
+    tp_budget.Start();
+    wl.ResetOpPacing();
+    std::future<void> status_future;
+    if (opt.show_status) {
+      status_future = std::async(std::launch::async, StatusThread,
+                                 measurements, &tp_sync.finished, opt.status_interval);
     }
+    std::future<void> rlim_future;
+    if (rate.rate_file != "") {
+      rlim_future = std::async(std::launch::async, RateLimitThread, rate.rate_file, rlim, &tp_sync.finished);
+    }
+    ap_sync.start.CountDown();
+    tp_sync.start.CountDown();
+
+    ap_sync.finished.Await();
+    ap_done = true;
+    tp_sync.finished.Await();
+    double runtime = timer.End();
 
-    int ap_sum = 0;
+    timer.Start();
+    int64_t ap_sum = 0;
     for (auto &n : client_ap_threads) {
       assert(n.valid());
       ap_sum += n.get();
     }
-
-    ap_done = true;
-
-    int tp_sum = 0;
+    int64_t tp_sum = 0;
     for (auto &n : client_tp_threads) {
       assert(n.valid());
       tp_sum += n.get();
     }
+    double cleanup_time = timer.End();
 
-    double runtime = timer.End();
-
-    if (show_status) {
+    if (opt.show_status) {
       status_future.wait();
     }
+    if (rate.rate_file != "") {
+      rlim_future.wait();
+    }
 
+    std::cout << "Run init time(sec): " << init_time << std::endl;
+    std::cout << "Run cleanup time(sec): " << cleanup_time << std::endl;
     std::cout << "Run runtime(sec): " << runtime << std::endl;
     std::cout << "Run AP operations(ops): " << ap_sum << std::endl;
     std::cout << "Run AP throughput(ops/sec): " << ap_sum / runtime << std::endl;
     std::cout << "Run TP operations(ops): " << tp_sum << std::endl;
     std::cout << "Run TP throughput(ops/sec): " << tp_sum / runtime << std::endl;
-    if(time_limit) {
-      delete time_limit;
-    }
+    PrintPacing("Run TP", rlim, rate.rate_file == "" ? rate.ops_limit : 0, tp_sum / runtime);
+    PrintOpPacing("Run TP", wl, runtime);
+    PrintPlacement("Run AP", ap_applied);
+    PrintPlacement("Run TP", tp_applied);
+    delete rlim;
   }
 
-  for (int i = 0; i < num_threads; i++) {
+  for (int i = 0; i < num_dbs; i++) {
     delete dbs[i];
   }
 }
@@ -385,6 +1451,43 @@ void ParseCommandLine(int argc, const char *argv[], ycsbc::utils::Properties &pr
       }
       props.SetProperty("apthreadcount", argv[argindex]);
       argindex++;
+    } else if (strcmp(argv[argindex], "-record") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument value for -record" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("record", argv[argindex]);
+      argindex++;
+    } else if (strcmp(argv[argindex], "-replay") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument value for -replay" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("replay", argv[argindex]);
+      props.SetProperty("dotransaction", "true");
+      argindex++;
+    } else if (strcmp(argv[argindex], "-snapshot") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument value for -snapshot" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("snapshot", argv[argindex]);
+      argindex++;
+    } else if (strcmp(argv[argindex], "-restore") == 0) {
+      argindex++;
+      if (argindex >= argc) {
+        UsageMessage(argv[0]);
+        std::cerr << "Missing argument value for -restore" << std::endl;
+        exit(0);
+      }
+      props.SetProperty("restore", argv[argindex]);
+      argindex++;
     } else if (strcmp(argv[argindex], "-db") == 0) {
       argindex++;
       if (argindex >= argc) {
@@ -460,13 +1563,60 @@ void UsageMessage(const char *command) {
       "  -threads n: execute using n threads (default: 1)\n"
       "  -apthreads n: number of ap threads in htap workload (default: 1)\n"
       "                works when htaptime is not set\n"
+      "  -record file: record the generated transactions to a binary trace file\n"
+      "  -replay file: run the transactions of a recorded trace instead of generating\n"
+      "                them, -p replay.speed=x replays x times as fast (0: back to back)\n"
+      "                and needs client.inflight=1 unless it is 0\n"
+      "  -snapshot dir: after the load phase, write a snapshot of the DB to the new\n"
+      "                 directory dir with the engine's checkpoint or backup facility\n"
+      "  -restore dir: replace the DB with the snapshot in dir before the first phase\n"
       "  -db dbname: specify the name of the DB to use (default: basic)\n"
       "  -P propertyfile: load properties from the given file. Multiple files can\n"
       "                   be specified, and will be processed in the order specified\n"
       "  -p name=value: specify a property to be passed to the DB and workloads\n"
       "                 multiple properties can be specified, and override any\n"
       "                 values in the propertyfile\n"
-      "  -s: print status every 10 seconds (use status.interval prop to override)"
+      "  -s: print status every 10 seconds (use status.interval prop to override)\n"
+      "  -p client.inflight=n: keep n operations outstanding per client thread using\n"
+      "                        coroutines (default: 1)\n"
+      "  -p client.cpuset=list: cpus client threads may run on, e.g. 0-7,16-23\n"
+      "  -p client.numa_policy=p: none, compact, scatter or per-node thread placement\n"
+      "                           (default: none)\n"
+      "  -p maxexecutiontime=n: stop each phase after n seconds (default: no limit),\n"
+      "                         operationcount=0 runs the transaction phase until then\n"
+      "  -p client.opchunk=n: operations a thread claims at once from the shared\n"
+      "                       operation budget (default: 100)\n"
+      "  -p warmup.ops=n / warmup.time=sec: run n operations or sec seconds of\n"
+      "                 transactions before the measured phase (default: none)\n"
+      "  -p warmup.converge=pct: end warmup once throughput and cache hit ratio\n"
+      "                          change by at most pct percent between two\n"
+      "                          warmup.interval periods (default: 1 sec)\n"
+      "  -p phases=a,b,...: run the listed phases in order on DBs kept open, each\n"
+      "                    phase of type load, warmup or run configured by\n"
+      "                    phase.<name>.<property> overrides (replaces -load/-run)\n"
+      "  -p limit.pattern=p: arrivals around the limited rate, uniform, poisson,\n"
+      "                     bursty (limit.burst.size, limit.burst.rate), sine or\n"
+      "                     diurnal (limit.pattern.amplitude, limit.pattern.period)\n"
+      "  -p limit.<op>.ops=n: pace an operation type, e.g. limit.read.ops, on its own;\n"
+      "                       other types use the remaining capacity\n"
+      "  -p limit.spin_us=n: rate limited threads spin for the last n us of a wait\n"
+      "                      instead of sleeping (default: 100)\n"
+      "  -p groups=a,b,...: run thread groups side by side in transaction phases, each\n"
+      "                    with its own group.<name>.threads, workload, limits and\n"
+      "                    measurements, e.g. group.a.readproportion=1\n"
+      "  -p trace.file=path: run the operations of a twitter cache trace or, with\n"
+      "                     trace.format=rocksdb, a rocksdb query trace in transaction\n"
+      "                     phases; trace.speed=x replays x times as fast (0: back to back)\n"
+      "  -p pregenerate=true: generate all operations of a transaction phase before it\n"
+      "                      starts and run them back to back, leaving generator cost\n"
+      "                      out of throughput (needs operationcount, no rate limits)\n"
+      "  -p load.mode=bulk: load sorted records in disjoint key ranges per thread through\n"
+      "                    the DB's bulk ingestion path, load.batch records per call\n"
+      "                    (default: 1000)\n"
+      "  -p slo.search=step|binary: search the highest rate whose slo.percentile\n"
+      "                            latency stays within slo.latency_us (needs\n"
+      "                            measurementtype=hdrhistogram)\n"
+      "  -p htap.ap_cpuset=list: cpus htap ap threads may run on (default: client.cpuset)"
       << std::endl;
 }
 
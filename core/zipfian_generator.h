@@ -9,21 +9,39 @@
 #ifndef YCSB_C_ZIPFIAN_GENERATOR_H_
 #define YCSB_C_ZIPFIAN_GENERATOR_H_
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
-#include <mutex>
 
 #include "generator.h"
 #include "utils/utils.h"
 
 namespace ycsbc {
 
+///
+/// Zipfian distribution over [min, max], or over [min, min + num_items) when
+/// Next is given the current number of items. The state for a growing number
+/// of items is updated without locks, so a generator whose number of items
+/// grows must not be shared by threads; each thread samples from a Clone().
+///
 class ZipfianGenerator : public Generator<uint64_t> {
  public:
   static constexpr double kZipfianConst = 0.99;
   static constexpr uint64_t kMaxNumItems = (UINT64_MAX >> 24);
 
+  ///
+  /// Sampling methods. kGray is the method of Gray et al. used by YCSB, which
+  /// approximates the distribution and needs zeta(n), computed in O(n) and
+  /// again whenever the number of items grows. kRejection is the
+  /// rejection-inversion method of Hoermann and Derflinger, which samples the
+  /// exact distribution in O(1) expected time with O(1) setup for any n.
+  ///
+  enum class Sampler {
+    kGray,
+    kRejection,
+  };
+
   ZipfianGenerator(uint64_t num_items) :
       ZipfianGenerator(0, num_items - 1) {}
 
@@ -31,7 +49,8 @@ class ZipfianGenerator : public Generator<uint64_t> {
       ZipfianGenerator(min, max, zipfian_const, Zeta(max - min + 1, zipfian_const)) {}
 
   ZipfianGenerator(uint64_t min, uint64_t max, double zipfian_const, double zeta_n) :
-      items_(max - min + 1), base_(min), theta_(zipfian_const), allow_count_decrease_(false) {
+      items_(max - min + 1), base_(min), theta_(zipfian_const), sampler_(Sampler::kGray),
+      h_integral_x1_(0), h_integral_n_(0), s_(0), allow_count_decrease_(false) {
     assert(items_ >= 2 && items_ < kMaxNumItems);
 
     zeta_2_ = Zeta(2, theta_);
@@ -44,12 +63,28 @@ class ZipfianGenerator : public Generator<uint64_t> {
     Next();
   }
 
+  ZipfianGenerator(uint64_t min, uint64_t max, double zipfian_const, Sampler sampler) :
+      ZipfianGenerator(min, max, zipfian_const,
+                       sampler == Sampler::kGray ? Zeta(max - min + 1, zipfian_const) : 0.0) {
+    sampler_ = sampler;
+    if (sampler_ == Sampler::kRejection) {
+      assert(theta_ > 0);
+      h_integral_x1_ = HIntegral(1.5) - 1.0;
+      h_integral_n_ = HIntegral(items_ + 0.5);
+      s_ = 2.0 - HIntegralInverse(HIntegral(2.5) - H(2.0));
+      Next();
+    }
+  }
+
   uint64_t Next(uint64_t num_items);
 
   uint64_t Next() { return Next(items_); }
 
   uint64_t Last();
 
+  Generator<uint64_t> *Clone() const { return new ZipfianGenerator(*this); }
+
+
  private:
   double Eta() {
     return (1 - std::pow(2.0 / items_, 1 - theta_)) / (1 - zeta_2_ / zeta_n_);
@@ -73,23 +108,66 @@ class ZipfianGenerator : public Generator<uint64_t> {
     return Zeta(0, num, theta, 0);
   }
 
+  uint64_t NextGray(uint64_t num);
+  uint64_t NextRejection(uint64_t num);
+
+  // H(x) = x^-theta, the unnormalized density of rank x >= 1
+  double H(double x) const {
+    return std::exp(-theta_ * std::log(x));
+  }
+
+  // an antiderivative of H, (x^(1-theta) - 1) / (1-theta), and its inverse
+  double HIntegral(double x) const {
+    const double log_x = std::log(x);
+    return Helper2((1.0 - theta_) * log_x) * log_x;
+  }
+
+  double HIntegralInverse(double x) const {
+    double t = x * (1.0 - theta_);
+    if (t < -1.0) {
+      // limit value of t for theta > 1, kept from rounding below it
+      t = -1.0;
+    }
+    return std::exp(Helper1(t) * x);
+  }
+
+  // log1p(x) / x and expm1(x) / x, continuous at x = 0
+  static double Helper1(double x) {
+    if (std::fabs(x) > 1e-8) {
+      return std::log1p(x) / x;
+    }
+    return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+  }
+
+  static double Helper2(double x) {
+    if (std::fabs(x) > 1e-8) {
+      return std::expm1(x) / x;
+    }
+    return 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+  }
+
   uint64_t items_;
   uint64_t base_; /// Min number of items to generate
 
   // Computed parameters for generating the distribution
   double theta_, zeta_n_, eta_, alpha_, zeta_2_;
+  Sampler sampler_;
+  // rejection-inversion parameters, h_integral_n_ is for count_for_zeta_ items
+  double h_integral_x1_, h_integral_n_, s_;
   uint64_t count_for_zeta_; /// Number of items used to compute zeta_n
   uint64_t last_value_;
-  std::mutex mutex_;
   bool allow_count_decrease_;
   friend class DistinctValueGenerator;
 };
 
 inline uint64_t ZipfianGenerator::Next(uint64_t num) {
   assert(num >= 2 && num < kMaxNumItems);
+  return last_value_ = sampler_ == Sampler::kGray ? NextGray(num) : NextRejection(num);
+}
+
+inline uint64_t ZipfianGenerator::NextGray(uint64_t num) {
   if (num != count_for_zeta_) {
-    // recompute zeta and eta
-    std::lock_guard<std::mutex> lock(mutex_);
+    // extend zeta incrementally and recompute eta
     if (num > count_for_zeta_) {
       zeta_n_ = Zeta(count_for_zeta_, num, theta_, zeta_n_);
       count_for_zeta_ = num;
@@ -103,14 +181,32 @@ inline uint64_t ZipfianGenerator::Next(uint64_t num) {
   double uz = u * zeta_n_;
 
   if (uz < 1.0) {
-    return last_value_ = base_;
+    return base_;
   }
 
   if (uz < 1.0 + std::pow(0.5, theta_)) {
-    return last_value_ = base_ + 1;
+    return base_ + 1;
   }
 
-  return last_value_ = base_ + num * std::pow(eta_ * u - eta_ + 1, alpha_);
+  return base_ + num * std::pow(eta_ * u - eta_ + 1, alpha_);
+}
+
+// Samples rank k in [1, num] by inverting the integral of H over [1/2, num + 1/2] and accepts
+// it unless the point falls above H(k); rejections are rare for any theta.
+inline uint64_t ZipfianGenerator::NextRejection(uint64_t num) {
+  if (num != count_for_zeta_) {
+    // only the upper end of the integral depends on the number of items
+    h_integral_n_ = HIntegral(num + 0.5);
+    count_for_zeta_ = num;
+  }
+  while (true) {
+    double u = h_integral_n_ + utils::ThreadLocalRandomDouble() * (h_integral_x1_ - h_integral_n_);
+    double x = HIntegralInverse(u);
+    uint64_t k = std::clamp<double>(x + 0.5, 1.0, static_cast<double>(num));
+    if (k - x <= s_ || u >= HIntegral(k + 0.5) - H(k)) {
+      return base_ + k - 1;
+    }
+  }
 }
 
 inline uint64_t ZipfianGenerator::Last() {
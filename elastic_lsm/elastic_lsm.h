@@ -9,6 +9,8 @@
 #ifndef YCSB_C_ELASTIC_LSM_H_
 #define YCSB_C_ELASTIC_LSM_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <mutex>
 
@@ -16,6 +18,7 @@
 #include "utils/properties.h"
 
 #include <rocksdb/elastic_lsm.h>
+#include <rocksdb/sst_file_writer.h>
 
 namespace ycsbc {
 
@@ -33,6 +36,11 @@ class ElasticLSMDB : public DB {
     return (this->*(method_read_))(table, key, fields, result);
   }
 
+  Status MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
+    return (this->*(method_multiread_))(table, keys, fields, result);
+  }
+
   Status Scan(const std::string &table, const std::string &key, int len,
               const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
     return (this->*(method_scan_))(table, key, len, fields, result);
@@ -50,6 +58,16 @@ class ElasticLSMDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status BulkInsert(const std::string &table, std::vector<Record> &records);
+
+  Status FinishBulkLoad(const std::string &table);
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
+  bool GetCompressionStats(uint64_t *raw_bytes, uint64_t *stored_bytes);
+
  private:
   enum RocksFormat {
     kSingleRow,
@@ -58,6 +76,7 @@ class ElasticLSMDB : public DB {
 
   void GetOptions(const utils::Properties &props, rocksdb::Options *opt,
                   std::vector<rocksdb::ColumnFamilyDescriptor> *cf_descs);
+  void FinishSstFile();
   static void SerializeRow(const std::vector<Field> &values, std::string &data);
   static void DeserializeRowFilter(std::vector<Field> &values, const char *p, const char *lim,
                                    const std::vector<std::string> &fields);
@@ -68,6 +87,9 @@ class ElasticLSMDB : public DB {
 
   Status ReadSingle(const std::string &table, const std::string &key,
                     const std::vector<std::string> *fields, std::vector<Field> &result);
+  Status MultiReadSingle(const std::string &table, const std::vector<std::string> &keys,
+                         const std::vector<std::string> *fields,
+                         std::vector<std::vector<Field>> &result);
   Status ScanSingle(const std::string &table, const std::string &key, int len,
                     const std::vector<std::string> *fields,
                     std::vector<std::vector<Field>> &result);
@@ -81,6 +103,9 @@ class ElasticLSMDB : public DB {
 
   Status (ElasticLSMDB::*method_read_)(const std::string &, const std:: string &,
                                     const std::vector<std::string> *, std::vector<Field> &);
+  Status (ElasticLSMDB::*method_multiread_)(const std::string &, const std::vector<std::string> &,
+                                  const std::vector<std::string> *,
+                                  std::vector<std::vector<Field>> &);
   Status (ElasticLSMDB::*method_scan_)(const std::string &, const std::string &,
                                     int, const std::vector<std::string> *,
                                     std::vector<std::vector<Field>> &);
@@ -92,6 +117,12 @@ class ElasticLSMDB : public DB {
 
   int fieldcount_;
 
+  // SST file of a bulk load being written, and the files written so far
+  std::unique_ptr<rocksdb::SstFileWriter> sst_writer_;
+  std::vector<std::string> sst_files_;
+  uint64_t sst_file_size_;
+  static std::atomic<uint64_t> sst_file_seq_;
+
   static std::vector<rocksdb::ColumnFamilyHandle *> cf_handles_;
   static rocksdb::DB *db_;
   static int ref_cnt_;
@@ -9,12 +9,15 @@
 #include "laser.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "utils/file_clone.h"
 #include "utils/utils.h"
 
 #include <rocksdb/cache.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/merge_operator.h>
 #include <rocksdb/status.h>
+#include <rocksdb/table_properties.h>
+#include <rocksdb/utilities/checkpoint.h>
 #include <rocksdb/utilities/options_util.h>
 #include <rocksdb/write_batch.h>
 
@@ -150,6 +153,7 @@ namespace ycsbc {
   std::vector<rocksdb::ColumnFamilyHandle *> LaserDB::cf_handles_;
   rocksdb::DB *LaserDB::db_ = nullptr;
   int LaserDB::ref_cnt_ = 0;
+std::atomic<uint64_t> LaserDB::sst_file_seq_{0};
   std::mutex LaserDB::mu_;
   
   void LaserDB::Init() {
@@ -202,6 +206,7 @@ namespace ycsbc {
   if (format == "single") {
     format_ = kSingleRow;
     method_read_ = &LaserDB::ReadSingle;
+    method_multiread_ = &LaserDB::MultiReadSingle;
     method_scan_ = &LaserDB::ScanSingle;
     method_update_ = &LaserDB::UpdateSingle;
     method_insert_ = &LaserDB::InsertSingle;
@@ -449,6 +454,32 @@ DB::Status LaserDB::ReadSingle(const std::string &table, const std::string &key,
   return kOK;
 }
 
+DB::Status LaserDB::MultiReadSingle(const std::string &table, const std::vector<std::string> &keys,
+                                 const std::vector<std::string> *fields,
+                                 std::vector<std::vector<Field>> &result) {
+  const size_t num_keys = keys.size();
+  std::vector<rocksdb::Slice> key_slices(keys.begin(), keys.end());
+  std::vector<std::string> values;
+  std::vector<rocksdb::Status> statuses = db_->MultiGet(rocksdb::ReadOptions(), key_slices, &values);
+  Status status = kOK;
+  ResizeRows(result, num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    if (statuses[i].IsNotFound()) {
+      status = kNotFound;
+      continue;
+    } else if (!statuses[i].ok()) {
+      throw utils::Exception(std::string("Laser MultiGet: ") + statuses[i].ToString());
+    }
+    if (fields != nullptr) {
+      DeserializeRowFilter(result[i], values[i], *fields);
+    } else {
+      DeserializeRow(result[i], values[i]);
+      assert(result[i].size() == static_cast<size_t>(fieldcount_));
+    }
+  }
+  return status;
+}
+
 DB::Status LaserDB::ScanSingle(const std::string &table, const std::string &key, int len,
                                  const std::vector<std::string> *fields,
                                  std::vector<std::vector<Field>> &result) {
@@ -456,8 +487,7 @@ DB::Status LaserDB::ScanSingle(const std::string &table, const std::string &key,
   db_iter->Seek(key);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
     std::string data = db_iter->value().ToString();
-    result.push_back(std::vector<Field>());
-    std::vector<Field> &values = result.back();
+    std::vector<Field> &values = AppendRow(result);
     if (fields != nullptr) {
       DeserializeRowFilter(values, data, *fields);
     } else {
@@ -528,6 +558,118 @@ DB::Status LaserDB::InsertSingle(const std::string &table, const std::string &ke
   return kOK;
 }
 
+// Records of a bulk load are written to SST files in the bulk directory of the DB, a new file
+// once one reaches the target file size, and ingested by FinishBulkLoad. The key ranges of
+// client threads are disjoint, so their files do not overlap.
+DB::Status LaserDB::BulkInsert(const std::string &table, std::vector<Record> &records) {
+  std::string data;
+  for (Record &record : records) {
+    rocksdb::Status s;
+    if (sst_writer_ && sst_writer_->FileSize() >= sst_file_size_) {
+      FinishSstFile();
+    }
+    if (!sst_writer_) {
+      const rocksdb::Options opt = db_->GetOptions();
+      const std::string dir = db_->GetName() + "/bulk";
+      s = db_->GetEnv()->CreateDirIfMissing(dir);
+      if (!s.ok()) {
+        throw utils::Exception(std::string("Laser CreateDirIfMissing: ") + s.ToString());
+      }
+      sst_files_.push_back(dir + "/" + std::to_string(sst_file_seq_++) + ".sst");
+      sst_file_size_ = opt.target_file_size_base;
+      sst_writer_.reset(new rocksdb::SstFileWriter(rocksdb::EnvOptions(), opt));
+      s = sst_writer_->Open(sst_files_.back());
+      if (!s.ok()) {
+        throw utils::Exception(std::string("Laser SstFileWriter Open: ") + s.ToString());
+      }
+    }
+    data.clear();
+    SerializeRow(record.values, data);
+    s = sst_writer_->Put(record.key, data);
+    if (!s.ok()) {
+      throw utils::Exception(std::string("Laser SstFileWriter Put: ") + s.ToString());
+    }
+  }
+  return kOK;
+}
+
+DB::Status LaserDB::FinishBulkLoad(const std::string &table) {
+  if (sst_writer_) {
+    FinishSstFile();
+  }
+  if (sst_files_.empty()) {
+    return kOK;
+  }
+  rocksdb::IngestExternalFileOptions opt;
+  opt.move_files = true;
+  rocksdb::Status s = db_->IngestExternalFile(sst_files_, opt);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("Laser IngestExternalFile: ") + s.ToString());
+  }
+  sst_files_.clear();
+  return kOK;
+}
+
+// A checkpoint hard links the SST files, so it is taken in constant time when dir is on the
+// same filesystem as the DB.
+DB::Status LaserDB::Snapshot(const std::string &dir) {
+  rocksdb::Checkpoint *checkpoint;
+  rocksdb::Status s = rocksdb::Checkpoint::Create(db_, &checkpoint);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("Laser Checkpoint: ") + s.ToString());
+  }
+  s = checkpoint->CreateCheckpoint(dir);
+  delete checkpoint;
+  if (!s.ok()) {
+    throw utils::Exception(std::string("Laser CreateCheckpoint: ") + s.ToString());
+  }
+  return kOK;
+}
+
+// The restored DB appends to the MANIFEST and WAL, so its files are cloned rather than linked.
+DB::Status LaserDB::Restore(const std::string &dir) {
+  const utils::Properties &props = *props_;
+  if (props.GetProperty(PROP_DESTROY, PROP_DESTROY_DEFAULT) == "true") {
+    throw utils::Exception(PROP_DESTROY + " would destroy the restored DB");
+  }
+  const std::string &db_path = props.GetProperty(PROP_NAME, PROP_NAME_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("Laser db path is missing");
+  }
+  utils::CloneTree(dir, db_path);
+  return kOK;
+}
+
+// Sizes of the SST files after a flush: raw keys and values against the data blocks written.
+bool LaserDB::GetCompressionStats(uint64_t *raw_bytes, uint64_t *stored_bytes) {
+  std::vector<rocksdb::ColumnFamilyHandle *> handles = cf_handles_;
+  if (handles.empty()) {
+    handles.push_back(db_->DefaultColumnFamily());
+  }
+  *raw_bytes = 0;
+  *stored_bytes = 0;
+  for (rocksdb::ColumnFamilyHandle *handle : handles) {
+    rocksdb::TablePropertiesCollection tables;
+    if (!db_->Flush(rocksdb::FlushOptions(), handle).ok() ||
+        !db_->GetPropertiesOfAllTables(handle, &tables).ok()) {
+      return false;
+    }
+    for (const auto &table : tables) {
+      *raw_bytes += table.second->raw_key_size + table.second->raw_value_size;
+      *stored_bytes += table.second->data_size;
+    }
+  }
+  return *stored_bytes > 0;
+}
+
+void LaserDB::FinishSstFile() {
+  rocksdb::Status s = sst_writer_->Finish();
+  if (!s.ok()) {
+    throw utils::Exception(std::string("Laser SstFileWriter Finish: ") + s.ToString());
+  }
+  sst_writer_.reset();
+}
+
 DB::Status LaserDB::DeleteSingle(const std::string &table, const std::string &key) {
   rocksdb::WriteOptions wopt;
   rocksdb::Status s = db_->Delete(wopt, key);
@@ -557,8 +699,7 @@ DB::Status LaserDB::FilterSingle(const std::string &table, const std::vector<Fie
     }
     assert(field_id < values.size());
     if (values[field_id].value >= l_value[0] && values[field_id].value <= r_value[0]) {
-      result.push_back(std::vector<Field>());
-      std::vector<Field> &result_values = result.back();
+      std::vector<Field> &result_values = AppendRow(result);
       if (fields != nullptr) {
         DeserializeRowFilter(result_values, data, *fields);
       } else {
@@ -17,6 +17,7 @@
 #include "rocksdb/db.h"
 #include <fstream>
 //#include "rocksdb/options.h"
+#include "rocksdb/sst_file_writer.h"
 #include "rocksdb/table.h"
 #include "rocksdb/iostats_context.h"
 #include "rocksdb/perf_context.h"
@@ -33,6 +34,7 @@
 #include <random>
 #include <ctime>
 #include <atomic>
+#include <memory>
 #include <algorithm>
 #include <iomanip>
 #include <set>
@@ -57,6 +59,11 @@ class LaserDB : public DB {
     return (this->*(method_read_))(table, key, fields, result);
   }
 
+  Status MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
+    return (this->*(method_multiread_))(table, keys, fields, result);
+  }
+
   Status Scan(const std::string &table, const std::string &key, int len,
               const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
     return (this->*(method_scan_))(table, key, len, fields, result);
@@ -74,6 +81,16 @@ class LaserDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status BulkInsert(const std::string &table, std::vector<Record> &records);
+
+  Status FinishBulkLoad(const std::string &table);
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
+  bool GetCompressionStats(uint64_t *raw_bytes, uint64_t *stored_bytes);
+
   Status Filter(const std::string &table, const std::vector<DB::Field> &lvalue,
                    const std::vector<DB::Field> &rvalue, const std::vector<std::string> *fields,
                    std::vector<std::vector<Field>> &result) {
@@ -88,6 +105,7 @@ class LaserDB : public DB {
 
   void GetOptions(const utils::Properties &props, rocksdb::Options *opt,
                   std::vector<rocksdb::ColumnFamilyDescriptor> *cf_descs);
+  void FinishSstFile();
   static void SerializeRow(const std::vector<Field> &values, std::string &data);
   static void DeserializeRowFilter(std::vector<Field> &values, const char *p, const char *lim,
                                    const std::vector<std::string> &fields);
@@ -98,6 +116,9 @@ class LaserDB : public DB {
 
   Status ReadSingle(const std::string &table, const std::string &key,
                     const std::vector<std::string> *fields, std::vector<Field> &result);
+  Status MultiReadSingle(const std::string &table, const std::vector<std::string> &keys,
+                         const std::vector<std::string> *fields,
+                         std::vector<std::vector<Field>> &result);
   Status ScanSingle(const std::string &table, const std::string &key, int len,
                     const std::vector<std::string> *fields,
                     std::vector<std::vector<Field>> &result);
@@ -114,6 +135,9 @@ class LaserDB : public DB {
 
   Status (LaserDB::*method_read_)(const std::string &, const std:: string &,
                                     const std::vector<std::string> *, std::vector<Field> &);
+  Status (LaserDB::*method_multiread_)(const std::string &, const std::vector<std::string> &,
+                                  const std::vector<std::string> *,
+                                  std::vector<std::vector<Field>> &);
   Status (LaserDB::*method_scan_)(const std::string &, const std::string &,
                                     int, const std::vector<std::string> *,
                                     std::vector<std::vector<Field>> &);
@@ -128,6 +152,12 @@ class LaserDB : public DB {
 
   int fieldcount_;
 
+  // SST file of a bulk load being written, and the files written so far
+  std::unique_ptr<rocksdb::SstFileWriter> sst_writer_;
+  std::vector<std::string> sst_files_;
+  uint64_t sst_file_size_;
+  static std::atomic<uint64_t> sst_file_seq_;
+
   static std::vector<rocksdb::ColumnFamilyHandle *> cf_handles_;
   static rocksdb::DB *db_;
   static int ref_cnt_;
@@ -273,8 +273,7 @@ DB::Status LeveldbDB::ScanSingleEntry(const std::string &table, const std::strin
   db_iter->Seek(key);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
     std::string data = db_iter->value().ToString();
-    result.push_back(std::vector<Field>());
-    std::vector<Field> &values = result.back();
+    std::vector<Field> &values = AppendRow(result);
     if (fields != nullptr) {
       DeserializeRowFilter(&values, data, *fields);
     } else {
@@ -390,8 +389,7 @@ DB::Status LeveldbDB::ScanCompKeyRM(const std::string &table, const std::string
   db_iter->Seek(key);
   assert(db_iter->Valid() && KeyFromCompKey(db_iter->key().ToString()) == key);
   for (int i = 0; i < len && db_iter->Valid(); i++) {
-    result.push_back(std::vector<Field>());
-    std::vector<Field> &values = result.back();
+    std::vector<Field> &values = AppendRow(result);
     if (fields != nullptr) {
       std::vector<std::string>::const_iterator filter_iter = fields->begin();
       for (int j = 0; j < fieldcount_ && filter_iter != fields->end() && db_iter->Valid(); j++) {
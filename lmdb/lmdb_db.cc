@@ -16,6 +16,7 @@
 #include "lmdb_db.h"
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "utils/file_clone.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
@@ -216,6 +217,39 @@ cleanup:
   return s;
 }
 
+DB::Status LmdbDB::MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                             const std::vector<std::string> *fields,
+                             std::vector<std::vector<Field>> &result) {
+  DB::Status s = kOK;
+  MDB_txn *txn;
+  MDB_val key_slice, val_slice;
+
+  int ret;
+  ret = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("MultiRead mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  ResizeRows(result, keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    key_slice.mv_data = static_cast<void *>(const_cast<char *>(keys[i].data()));
+    key_slice.mv_size = keys[i].size();
+    ret = mdb_get(txn, dbi_, &key_slice, &val_slice);
+    if (ret == MDB_NOTFOUND) {
+      s = kNotFound;
+      continue;
+    } else if (ret) {
+      throw utils::Exception(std::string("MultiRead mdb_get: ") + mdb_strerror(ret));
+    }
+    if (fields != nullptr) {
+      DeserializeRowFilter(&result[i], static_cast<char *>(val_slice.mv_data), val_slice.mv_size, *fields);
+    } else {
+      DeserializeRow(&result[i], static_cast<char *>(val_slice.mv_data), val_slice.mv_size);
+    }
+  }
+  mdb_txn_abort(txn);
+  return s;
+}
+
 DB::Status LmdbDB::Scan(const std::string &table, const std::string &key, int len,
                         const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
   DB::Status s = kOK;
@@ -243,8 +277,7 @@ DB::Status LmdbDB::Scan(const std::string &table, const std::string &key, int le
     throw utils::Exception(std::string("Scan mdb_cursor_get: ") + mdb_strerror(ret));
   }
   for (int i = 0; !ret && i < len; i++) {
-    result.push_back(std::vector<Field>());
-    std::vector<Field> &values = result.back();
+    std::vector<Field> &values = AppendRow(result);
     if (fields != nullptr) {
       DeserializeRowFilter(&values, static_cast<char *>(val_slice.mv_data), val_slice.mv_size, *fields);
     } else {
@@ -332,6 +365,69 @@ DB::Status LmdbDB::Insert(const std::string &table, const std::string &key, std:
   return kOK;
 }
 
+// A bulk load batch is one transaction whose records are appended to the end of the tree
+// without a search. Records below the last key, e.g. when the range of another client thread
+// was written first, fall back to a regular put.
+DB::Status LmdbDB::BulkInsert(const std::string &table, std::vector<Record> &records) {
+  MDB_txn *txn;
+  MDB_cursor *cursor;
+  MDB_val key_slice, val_slice;
+
+  int ret;
+  ret = mdb_txn_begin(env_, nullptr, 0, &txn);
+  if (ret) {
+    throw utils::Exception(std::string("BulkInsert mdb_txn_begin: ") + mdb_strerror(ret));
+  }
+  ret = mdb_cursor_open(txn, dbi_, &cursor);
+  if (ret) {
+    throw utils::Exception(std::string("BulkInsert mdb_cursor_open: ") + mdb_strerror(ret));
+  }
+  std::string data;
+  for (Record &record : records) {
+    key_slice.mv_data = static_cast<void *>(const_cast<char *>(record.key.data()));
+    key_slice.mv_size = record.key.size();
+    data.clear();
+    SerializeRow(record.values, &data);
+    val_slice.mv_data = static_cast<void *>(const_cast<char *>(data.data()));
+    val_slice.mv_size = data.size();
+    ret = mdb_cursor_put(cursor, &key_slice, &val_slice, MDB_APPEND);
+    if (ret == MDB_KEYEXIST) {
+      ret = mdb_cursor_put(cursor, &key_slice, &val_slice, 0);
+    }
+    if (ret) {
+      throw utils::Exception(std::string("BulkInsert mdb_cursor_put: ") + mdb_strerror(ret));
+    }
+  }
+  mdb_cursor_close(cursor);
+  ret = mdb_txn_commit(txn);
+  if (ret) {
+    throw utils::Exception(std::string("BulkInsert mdb_txn_commit: ") + mdb_strerror(ret));
+  }
+  return kOK;
+}
+
+// The copy is compacted: free pages are left out and the tree is rewritten in key order.
+DB::Status LmdbDB::Snapshot(const std::string &dir) {
+  int ret = mkdir(dir.c_str(), 0775);
+  if (ret) {
+    throw utils::Exception(std::string("Snapshot mkdir: ") + strerror(errno));
+  }
+  ret = mdb_env_copy2(env_, dir.c_str(), MDB_CP_COMPACT);
+  if (ret) {
+    throw utils::Exception(std::string("Snapshot mdb_env_copy2: ") + mdb_strerror(ret));
+  }
+  return kOK;
+}
+
+DB::Status LmdbDB::Restore(const std::string &dir) {
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("LMDB db path is missing");
+  }
+  utils::CloneTree(dir, db_path);
+  return kOK;
+}
+
 DB::Status LmdbDB::Delete(const std::string &table, const std::string &key) {
   MDB_txn *txn;
   MDB_val key_slice;
@@ -29,6 +29,9 @@ class LmdbDB : public DB {
   Status Read(const std::string &table, const std::string &key,
               const std::vector<std::string> *fields, std::vector<Field> &result);
 
+  Status MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result);
+
   Status Scan(const std::string &table, const std::string &key, int len,
               const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result);
 
@@ -38,6 +41,12 @@ class LmdbDB : public DB {
 
   Status Delete(const std::string &table, const std::string &key);
 
+  Status BulkInsert(const std::string &table, std::vector<Record> &records);
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
  private:
   void SerializeRow(const std::vector<Field> &values, std::string *data);
   void DeserializeRowFilter(std::vector<Field> *values, const char *data_ptr, size_t data_len,
@@ -10,12 +10,16 @@
 
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "utils/file_clone.h"
 #include "utils/utils.h"
 #include "iostream"
 #include <rocksdb/cache.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/merge_operator.h>
+#include <rocksdb/statistics.h>
 #include <rocksdb/status.h>
+#include <rocksdb/table_properties.h>
+#include <rocksdb/utilities/checkpoint.h>
 #include <rocksdb/utilities/options_util.h>
 #include <rocksdb/write_batch.h>
 #include <rocksdb/iostats_context.h>
@@ -115,7 +119,11 @@ namespace {
   const std::string PROP_FS_URI = "rocksdb.fs_uri";
   const std::string PROP_FS_URI_DEFAULT = "";
 
+  const std::string PROP_STATISTICS = "rocksdb.statistics";
+  const std::string PROP_STATISTICS_DEFAULT = "false";
+
   static std::shared_ptr<rocksdb::Env> env_guard;
+  static std::shared_ptr<rocksdb::Statistics> statistics;
   static std::shared_ptr<rocksdb::Cache> block_cache;
 #if ROCKSDB_MAJOR < 8
   static std::shared_ptr<rocksdb::Cache> block_cache_compressed;
@@ -127,6 +135,7 @@ namespace ycsbc {
 std::vector<rocksdb::ColumnFamilyHandle *> RocksdbDB::cf_handles_;
 rocksdb::DB *RocksdbDB::db_ = nullptr;
 int RocksdbDB::ref_cnt_ = 0;
+std::atomic<uint64_t> RocksdbDB::sst_file_seq_{0};
 std::mutex RocksdbDB::mu_;
 
 void RocksdbDB::Init() {
@@ -179,6 +188,7 @@ void RocksdbDB::Init() {
   if (format == "single") {
     format_ = kSingleRow;
     method_read_ = &RocksdbDB::ReadSingle;
+    method_multiread_ = &RocksdbDB::MultiReadSingle;
     method_scan_ = &RocksdbDB::ScanSingle;
     method_update_ = &RocksdbDB::UpdateSingle;
     method_insert_ = &RocksdbDB::InsertSingle;
@@ -406,6 +416,20 @@ void RocksdbDB::GetOptions(const utils::Properties &props, rocksdb::Options *opt
       opt->OptimizeLevelStyleCompaction();
     }
   }
+
+  if (props.GetProperty(PROP_STATISTICS, PROP_STATISTICS_DEFAULT) == "true") {
+    statistics = rocksdb::CreateDBStatistics();
+    opt->statistics = statistics;
+  }
+}
+
+bool RocksdbDB::GetCacheStats(uint64_t *hits, uint64_t *misses) {
+  if (!statistics) {
+    return false;
+  }
+  *hits = statistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT);
+  *misses = statistics->getTickerCount(rocksdb::BLOCK_CACHE_MISS);
+  return true;
 }
 
 void RocksdbDB::SerializeRow(const std::vector<Field> &values, std::string &data) {
@@ -488,6 +512,37 @@ DB::Status RocksdbDB::ReadSingle(const std::string &table, const std::string &ke
   return kOK;
 }
 
+DB::Status RocksdbDB::MultiReadSingle(const std::string &table, const std::vector<std::string> &keys,
+                                      const std::vector<std::string> *fields,
+                                      std::vector<std::vector<Field>> &result) {
+  rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeAndCPUTimeExceptForMutex);
+  const size_t num_keys = keys.size();
+  std::vector<rocksdb::Slice> key_slices(keys.begin(), keys.end());
+  std::vector<rocksdb::PinnableSlice> values(num_keys);
+  std::vector<rocksdb::Status> statuses(num_keys);
+  db_->MultiGet(rocksdb::ReadOptions(), db_->DefaultColumnFamily(), num_keys,
+                key_slices.data(), values.data(), statuses.data());
+  Status status = kOK;
+  ResizeRows(result, num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    if (statuses[i].IsNotFound()) {
+      status = kNotFound;
+      continue;
+    } else if (!statuses[i].ok()) {
+      throw utils::Exception(std::string("RocksDB MultiGet: ") + statuses[i].ToString());
+    }
+    const char *p = values[i].data();
+    const char *lim = p + values[i].size();
+    if (fields != nullptr) {
+      DeserializeRowFilter(result[i], p, lim, *fields);
+    } else {
+      DeserializeRow(result[i], p, lim);
+      assert(result[i].size() == static_cast<size_t>(fieldcount_));
+    }
+  }
+  return status;
+}
+
 DB::Status RocksdbDB::ScanSingle(const std::string &table, const std::string &key, int len,
                                  const std::vector<std::string> *fields,
                                  std::vector<std::vector<Field>> &result){      
@@ -496,8 +551,7 @@ DB::Status RocksdbDB::ScanSingle(const std::string &table, const std::string &ke
   db_iter->Seek(key);
   for (int i = 0; db_iter->Valid() && i < len; i++) {
     std::string data = db_iter->value().ToString();
-    result.push_back(std::vector<Field>());
-    std::vector<Field> &values = result.back();
+    std::vector<Field> &values = AppendRow(result);
     if (fields != nullptr) {
       DeserializeRowFilter(values, data, *fields);
     } else {
@@ -571,6 +625,118 @@ DB::Status RocksdbDB::InsertSingle(const std::string &table, const std::string &
   return kOK;
 }
 
+// Records of a bulk load are written to SST files in the bulk directory of the DB, a new file
+// once one reaches the target file size, and ingested by FinishBulkLoad. The key ranges of
+// client threads are disjoint, so their files do not overlap.
+DB::Status RocksdbDB::BulkInsert(const std::string &table, std::vector<Record> &records) {
+  std::string data;
+  for (Record &record : records) {
+    rocksdb::Status s;
+    if (sst_writer_ && sst_writer_->FileSize() >= sst_file_size_) {
+      FinishSstFile();
+    }
+    if (!sst_writer_) {
+      const rocksdb::Options opt = db_->GetOptions();
+      const std::string dir = db_->GetName() + "/bulk";
+      s = db_->GetEnv()->CreateDirIfMissing(dir);
+      if (!s.ok()) {
+        throw utils::Exception(std::string("RocksDB CreateDirIfMissing: ") + s.ToString());
+      }
+      sst_files_.push_back(dir + "/" + std::to_string(sst_file_seq_++) + ".sst");
+      sst_file_size_ = opt.target_file_size_base;
+      sst_writer_.reset(new rocksdb::SstFileWriter(rocksdb::EnvOptions(), opt));
+      s = sst_writer_->Open(sst_files_.back());
+      if (!s.ok()) {
+        throw utils::Exception(std::string("RocksDB SstFileWriter Open: ") + s.ToString());
+      }
+    }
+    data.clear();
+    SerializeRow(record.values, data);
+    s = sst_writer_->Put(record.key, data);
+    if (!s.ok()) {
+      throw utils::Exception(std::string("RocksDB SstFileWriter Put: ") + s.ToString());
+    }
+  }
+  return kOK;
+}
+
+DB::Status RocksdbDB::FinishBulkLoad(const std::string &table) {
+  if (sst_writer_) {
+    FinishSstFile();
+  }
+  if (sst_files_.empty()) {
+    return kOK;
+  }
+  rocksdb::IngestExternalFileOptions opt;
+  opt.move_files = true;
+  rocksdb::Status s = db_->IngestExternalFile(sst_files_, opt);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB IngestExternalFile: ") + s.ToString());
+  }
+  sst_files_.clear();
+  return kOK;
+}
+
+// A checkpoint hard links the SST files, so it is taken in constant time when dir is on the
+// same filesystem as the DB.
+DB::Status RocksdbDB::Snapshot(const std::string &dir) {
+  rocksdb::Checkpoint *checkpoint;
+  rocksdb::Status s = rocksdb::Checkpoint::Create(db_, &checkpoint);
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB Checkpoint: ") + s.ToString());
+  }
+  s = checkpoint->CreateCheckpoint(dir);
+  delete checkpoint;
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB CreateCheckpoint: ") + s.ToString());
+  }
+  return kOK;
+}
+
+// The restored DB appends to the MANIFEST and WAL, so its files are cloned rather than linked.
+DB::Status RocksdbDB::Restore(const std::string &dir) {
+  const utils::Properties &props = *props_;
+  if (props.GetProperty(PROP_DESTROY, PROP_DESTROY_DEFAULT) == "true") {
+    throw utils::Exception(PROP_DESTROY + " would destroy the restored DB");
+  }
+  const std::string &db_path = props.GetProperty(PROP_NAME, PROP_NAME_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("RocksDB db path is missing");
+  }
+  utils::CloneTree(dir, db_path);
+  return kOK;
+}
+
+// Sizes of the SST files after a flush: raw keys and values against the data blocks written.
+bool RocksdbDB::GetCompressionStats(uint64_t *raw_bytes, uint64_t *stored_bytes) {
+  std::vector<rocksdb::ColumnFamilyHandle *> handles = cf_handles_;
+  if (handles.empty()) {
+    handles.push_back(db_->DefaultColumnFamily());
+  }
+  *raw_bytes = 0;
+  *stored_bytes = 0;
+  for (rocksdb::ColumnFamilyHandle *handle : handles) {
+    rocksdb::TablePropertiesCollection tables;
+    if (!db_->Flush(rocksdb::FlushOptions(), handle).ok() ||
+        !db_->GetPropertiesOfAllTables(handle, &tables).ok()) {
+      return false;
+    }
+    for (const auto &table : tables) {
+      *raw_bytes += table.second->raw_key_size + table.second->raw_value_size;
+      *stored_bytes += table.second->data_size;
+    }
+  }
+  return *stored_bytes > 0;
+}
+
+void RocksdbDB::FinishSstFile() {
+  rocksdb::Status s = sst_writer_->Finish();
+  if (!s.ok()) {
+    throw utils::Exception(std::string("RocksDB SstFileWriter Finish: ") + s.ToString());
+  }
+  sst_writer_.reset();
+}
+
 DB::Status RocksdbDB::DeleteSingle(const std::string &table, const std::string &key) {
   rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeAndCPUTimeExceptForMutex);
   rocksdb::WriteOptions wopt;
@@ -602,8 +768,7 @@ DB::Status RocksdbDB::FilterSingle(const std::string &table, const std::vector<F
     }
     assert(field_id < values.size());
     if (values[field_id].value >= l_value[0] && values[field_id].value <= r_value[0]) {
-      result.push_back(std::vector<Field>());
-      std::vector<Field> &result_values = result.back();
+      std::vector<Field> &result_values = AppendRow(result);
       if (fields != nullptr) {
         DeserializeRowFilter(result_values, data, *fields);
       } else {
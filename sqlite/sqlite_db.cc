@@ -5,8 +5,11 @@
 //  Copyright (c) 2023 Youngjae Lee <ls4154.lee@gmail.com>.
 //
 
+#include <filesystem>
+
 #include "query_builder.h"
 #include "core/db_factory.h"
+#include "utils/file_clone.h"
 #include "utils/properties.h"
 #include "utils/utils.h"
 
@@ -271,8 +274,7 @@ DB::Status SqliteDB::Scan(const std::string &table, const std::string &key, int
     if (rc != SQLITE_ROW) {
       break;
     }
-    result.push_back(std::vector<Field>());
-    std::vector<Field> &values = result.back();
+    std::vector<Field> &values = AppendRow(result);
     values.reserve(field_cnt);
     // const char *user_id = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
     for (size_t i = 0; i < field_cnt; i++) {
@@ -385,6 +387,71 @@ cleanup:
   return s;
 }
 
+// Each batch of a bulk load is one transaction. Client threads share the connection, so the
+// transaction holds the lock until it commits.
+DB::Status SqliteDB::BulkInsert(const std::string &table, std::vector<Record> &records) {
+  const std::lock_guard<std::mutex> lock(mu_);
+  int rc = sqlite3_exec(db_, "BEGIN", nullptr, nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("BulkInsert begin: ") + sqlite3_errmsg(db_));
+  }
+  DB::Status s = kOK;
+  for (Record &record : records) {
+    if (Insert(table, record.key, record.values) != kOK) {
+      s = kError;
+    }
+  }
+  rc = sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("BulkInsert commit: ") + sqlite3_errmsg(db_));
+  }
+  return s;
+}
+
+// The snapshot is a database file of the same name in dir, written with the online backup API.
+DB::Status SqliteDB::Snapshot(const std::string &dir) {
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  std::error_code ec;
+  if (!std::filesystem::create_directory(dir, ec)) {
+    throw utils::Exception("Snapshot mkdir: " + dir);
+  }
+  const std::string path = (std::filesystem::path(dir) / std::filesystem::path(db_path).filename()).string();
+  sqlite3 *dst;
+  int rc = sqlite3_open_v2(path.c_str(), &dst, SQLITE_OPEN_READWRITE|SQLITE_OPEN_CREATE, nullptr);
+  if (rc != SQLITE_OK) {
+    std::string msg = std::string("Snapshot open: ") + sqlite3_errmsg(dst);
+    sqlite3_close(dst);
+    throw utils::Exception(msg);
+  }
+  const std::lock_guard<std::mutex> lock(mu_);
+  sqlite3_backup *backup = sqlite3_backup_init(dst, "main", db_, "main");
+  if (backup == nullptr) {
+    std::string msg = std::string("Snapshot backup: ") + sqlite3_errmsg(dst);
+    sqlite3_close(dst);
+    throw utils::Exception(msg);
+  }
+  sqlite3_backup_step(backup, -1);
+  rc = sqlite3_backup_finish(backup);
+  sqlite3_close(dst);
+  if (rc != SQLITE_OK) {
+    throw utils::Exception(std::string("Snapshot backup: ") + sqlite3_errstr(rc));
+  }
+  return kOK;
+}
+
+DB::Status SqliteDB::Restore(const std::string &dir) {
+  const std::string &db_path = props_->GetProperty(PROP_DBPATH, PROP_DBPATH_DEFAULT);
+  if (db_path == "") {
+    throw utils::Exception("SQLite db path is missing");
+  }
+  std::error_code ec;
+  for (const char *suffix : {"", "-wal", "-shm", "-journal"}) {
+    std::filesystem::remove(db_path + suffix, ec);
+  }
+  utils::CloneFile((std::filesystem::path(dir) / std::filesystem::path(db_path).filename()).string(), db_path);
+  return kOK;
+}
+
 DB::Status SqliteDB::Delete(const std::string &table, const std::string &key) {
   DB::Status s = kOK;
   sqlite3_stmt *stmt = stmt_delete_;
@@ -38,6 +38,12 @@ class SqliteDB : public DB {
 
   Status Delete(const std::string &table, const std::string &key);
 
+  Status BulkInsert(const std::string &table, std::vector<Record> &records);
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
  private:
   void OpenDB();
   void SetPragma();
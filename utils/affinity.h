@@ -0,0 +1,242 @@
+//
+//  affinity.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_AFFINITY_H_
+#define YCSB_C_AFFINITY_H_
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Parses a Linux style cpu list, e.g. "0-3,8,10-11".
+///
+inline std::vector<int> ParseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    std::string range = Trim(list.substr(pos, end - pos));
+    pos = end + 1;
+    if (range.empty()) {
+      continue;
+    }
+    try {
+      size_t dash = range.find('-');
+      int first = std::stoi(range.substr(0, dash));
+      int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      if (first < 0 || last < first) {
+        throw Exception("Invalid cpu list: " + list);
+      }
+      for (int cpu = first; cpu <= last; cpu++) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::logic_error &) {
+      throw Exception("Invalid cpu list: " + list);
+    }
+  }
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+///
+/// Formats cpus as a compact cpu list, the inverse of ParseCpuList.
+///
+inline std::string FormatCpuList(const std::vector<int> &cpus) {
+  std::string list;
+  for (size_t i = 0; i < cpus.size(); i++) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      j++;
+    }
+    if (!list.empty()) {
+      list.push_back(',');
+    }
+    list.append(std::to_string(cpus[i]));
+    if (j > i) {
+      list.push_back('-');
+      list.append(std::to_string(cpus[j]));
+    }
+    i = j;
+  }
+  return list;
+}
+
+///
+/// Returns the cpus of each NUMA node, read from sysfs.
+/// Falls back to a single node holding all online cpus.
+///
+inline std::vector<std::vector<int>> NumaNodeCpus() {
+  std::vector<std::pair<int, std::vector<int>>> nodes;
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+        !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+      continue;
+    }
+    std::ifstream input(entry.path() / "cpulist");
+    std::string list;
+    if (std::getline(input, list)) {
+      std::vector<int> cpus = ParseCpuList(list);
+      if (!cpus.empty()) {
+        nodes.emplace_back(std::stoi(name.substr(4)), cpus);
+      }
+    }
+  }
+  std::sort(nodes.begin(), nodes.end());
+
+  std::vector<std::vector<int>> node_cpus;
+  for (auto &node : nodes) {
+    node_cpus.push_back(std::move(node.second));
+  }
+  if (node_cpus.empty()) {
+    std::ifstream input("/sys/devices/system/cpu/online");
+    std::string list;
+    std::vector<int> cpus;
+    if (std::getline(input, list)) {
+      cpus = ParseCpuList(list);
+    }
+    if (cpus.empty()) {
+      for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); i++) {
+        cpus.push_back(i);
+      }
+    }
+    node_cpus.push_back(cpus);
+  }
+  return node_cpus;
+}
+
+///
+/// Plans the cpus each of num_threads threads is bound to.
+/// cpuset restricts the usable cpus (all cpus if empty). policy is one of
+///   none:     threads float over cpuset (no binding if cpuset is empty)
+///   compact:  one cpu per thread, filling a NUMA node before the next one
+///   scatter:  one cpu per thread, round-robin over NUMA nodes
+///   per-node: each thread bound to all cpuset cpus of a node, round-robin
+/// An empty entry means the thread is not bound.
+///
+inline std::vector<std::vector<int>> PlanThreadPlacement(int num_threads, const std::string &cpuset,
+                                                         const std::string &policy) {
+  std::vector<std::vector<int>> plan(num_threads);
+  if (policy == "none" && cpuset.empty()) {
+    return plan;
+  }
+
+  std::vector<std::vector<int>> nodes = NumaNodeCpus();
+  std::vector<int> allowed;
+  if (cpuset.empty()) {
+    for (const auto &node : nodes) {
+      allowed.insert(allowed.end(), node.begin(), node.end());
+    }
+  } else {
+    allowed = ParseCpuList(cpuset);
+  }
+  if (allowed.empty()) {
+    throw Exception("Empty cpuset: " + cpuset);
+  }
+
+  std::vector<std::vector<int>> node_allowed;
+  std::vector<int> assigned;
+  for (const auto &node : nodes) {
+    std::vector<int> cpus;
+    std::copy_if(node.begin(), node.end(), std::back_inserter(cpus),
+                 [&](int cpu) { return std::binary_search(allowed.begin(), allowed.end(), cpu); });
+    if (!cpus.empty()) {
+      assigned.insert(assigned.end(), cpus.begin(), cpus.end());
+      node_allowed.push_back(std::move(cpus));
+    }
+  }
+  // cpus unknown to the topology form an extra node
+  std::sort(assigned.begin(), assigned.end());
+  std::vector<int> rest;
+  std::set_difference(allowed.begin(), allowed.end(), assigned.begin(), assigned.end(),
+                      std::back_inserter(rest));
+  if (!rest.empty()) {
+    node_allowed.push_back(std::move(rest));
+  }
+
+  const size_t num_nodes = node_allowed.size();
+  if (policy == "none") {
+    std::fill(plan.begin(), plan.end(), allowed);
+  } else if (policy == "compact") {
+    std::vector<int> flat;
+    for (const auto &cpus : node_allowed) {
+      flat.insert(flat.end(), cpus.begin(), cpus.end());
+    }
+    for (int i = 0; i < num_threads; i++) {
+      plan[i] = {flat[i % flat.size()]};
+    }
+  } else if (policy == "scatter") {
+    for (int i = 0; i < num_threads; i++) {
+      const std::vector<int> &cpus = node_allowed[i % num_nodes];
+      plan[i] = {cpus[(i / num_nodes) % cpus.size()]};
+    }
+  } else if (policy == "per-node") {
+    for (int i = 0; i < num_threads; i++) {
+      plan[i] = node_allowed[i % num_nodes];
+    }
+  } else {
+    throw Exception("Unknown numa policy: " + policy);
+  }
+  return plan;
+}
+
+///
+/// Binds the calling thread to cpus (no-op if empty or unsupported).
+/// Returns the affinity actually applied, as reported by the OS.
+///
+inline std::vector<int> SetThreadAffinity(const std::vector<int> &cpus) {
+  std::vector<int> applied;
+#ifdef __linux__
+  if (cpus.empty()) {
+    return applied;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      throw Exception("cpu out of range: " + std::to_string(cpu));
+    }
+    CPU_SET(cpu, &set);
+  }
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+    throw Exception("failed to set thread affinity to " + FormatCpuList(cpus));
+  }
+  CPU_ZERO(&set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set)) {
+        applied.push_back(cpu);
+      }
+    }
+  }
+#endif
+  return applied;
+}
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_AFFINITY_H_
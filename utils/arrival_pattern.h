@@ -0,0 +1,135 @@
+//
+//  arrival_pattern.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_ARRIVAL_PATTERN_H_
+#define YCSB_C_ARRIVAL_PATTERN_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Arrival process shaping the gaps between operations released by a RateLimiter.
+/// Gaps are in picoseconds and average to the mean gap of the limiter's rate.
+///
+class ArrivalPattern {
+ public:
+  virtual ~ArrivalPattern() = default;
+
+  ///
+  /// Gap before the next operation, given the mean gap of the current rate and the
+  /// time in picoseconds since the limiter started.
+  ///
+  virtual int64_t Gap(int64_t interval, int64_t now) = 0;
+};
+
+///
+/// Poisson arrivals, exponentially distributed gaps.
+///
+class PoissonArrival : public ArrivalPattern {
+ public:
+  int64_t Gap(int64_t interval, int64_t now) override {
+    return static_cast<int64_t>(-std::log(1.0 - ThreadLocalRandomDouble()) * interval);
+  }
+};
+
+///
+/// On/off arrivals: bursts of burst_size operations at peak_rate operations per second
+/// (back to back if 0), separated by idle periods that keep the mean rate.
+///
+class BurstArrival : public ArrivalPattern {
+ public:
+  BurstArrival(int64_t burst_size, int64_t peak_rate)
+      : burst_size_(std::max<int64_t>(burst_size, 1)),
+        peak_gap_(peak_rate > 0 ? static_cast<int64_t>(1e12 / peak_rate) : 0) {}
+
+  int64_t Gap(int64_t interval, int64_t now) override {
+    int64_t seq = seq_.fetch_add(1, std::memory_order_relaxed);
+    if ((seq + 1) % burst_size_ != 0) {
+      return std::min(peak_gap_, interval);
+    }
+    // the burst is over, idle for the rest of the burst's share of time
+    return std::max<int64_t>(burst_size_ * interval - (burst_size_ - 1) * std::min(peak_gap_, interval), 0);
+  }
+
+ private:
+  const int64_t burst_size_;
+  const int64_t peak_gap_;
+  std::atomic<int64_t> seq_{0};
+};
+
+///
+/// Rate following a periodic curve, rate * (1 + amplitude * shape(t)).
+///
+class PeriodicArrival : public ArrivalPattern {
+ public:
+  PeriodicArrival(double amplitude, double period_sec) : amplitude_(amplitude), period_(period_sec * 1e12) {}
+
+  int64_t Gap(int64_t interval, int64_t now) override {
+    double phase = std::fmod(now / period_, 1.0);
+    // never stall completely at the bottom of the curve
+    double factor = std::max(1.0 + amplitude_ * Shape(phase), kMinFactor);
+    return static_cast<int64_t>(interval / factor);
+  }
+
+ protected:
+  ///
+  /// Deviation from the mean rate at phase in [0, 1), averaging to 0 over a period.
+  ///
+  virtual double Shape(double phase) const = 0;
+
+ private:
+  static constexpr double kMinFactor = 0.01;
+  const double amplitude_;
+  const double period_;
+};
+
+class SineArrival : public PeriodicArrival {
+ public:
+  using PeriodicArrival::PeriodicArrival;
+
+ protected:
+  double Shape(double phase) const override { return std::sin(2 * M_PI * phase); }
+};
+
+///
+/// Daily traffic curve starting at midnight, low at night and peaking in the evening,
+/// interpolated between hourly samples.
+///
+class DiurnalArrival : public PeriodicArrival {
+ public:
+  using PeriodicArrival::PeriodicArrival;
+
+ protected:
+  double Shape(double phase) const override {
+    static constexpr double kHourly[24] = {
+        -0.55, -0.65, -0.72, -0.76, -0.77, -0.73, -0.62, -0.45, -0.25, -0.08, 0.05, 0.15,
+        0.20,  0.22,  0.25,  0.28,  0.30,  0.32,  0.35,  0.38,  0.30,  0.10,  -0.15, -0.40};
+    static const double kMean = [] {
+      double sum = 0;
+      for (double x : kHourly) {
+        sum += x;
+      }
+      return sum / 24;
+    }();
+    double hour = phase * 24;
+    int h = static_cast<int>(hour) % 24;
+    double frac = hour - static_cast<int>(hour);
+    return kHourly[h] + (kHourly[(h + 1) % 24] - kHourly[h]) * frac - kMean;
+  }
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_ARRIVAL_PATTERN_H_
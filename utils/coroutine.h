@@ -0,0 +1,122 @@
+//
+//  coroutine.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_COROUTINE_H_
+#define YCSB_C_COROUTINE_H_
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace ycsbc {
+
+namespace utils {
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+      std::coroutine_handle<> continuation = h.promise().continuation_;
+      return continuation ? continuation : std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() { exception_ = std::current_exception(); }
+
+  std::coroutine_handle<> continuation_;
+  std::exception_ptr exception_;
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+  Task<T> get_return_object();
+  void return_value(T value) { value_ = std::move(value); }
+  T Result() {
+    if (exception_) {
+      std::rethrow_exception(exception_);
+    }
+    return std::move(value_);
+  }
+
+  T value_{};
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+  Task<void> get_return_object();
+  void return_void() const noexcept {}
+  void Result() {
+    if (exception_) {
+      std::rethrow_exception(exception_);
+    }
+  }
+};
+
+} // detail
+
+///
+/// Lazily started coroutine returning T.
+/// Awaiting a task runs it until it completes and resumes the awaiter by
+/// symmetric transfer, so chains of tasks do not grow the stack.
+/// A top-level task is started with Start() and driven until Done().
+///
+template <typename T>
+class Task {
+ public:
+  using promise_type = detail::TaskPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  explicit Task(Handle handle) : handle_(handle) {}
+  Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  void Start() { handle_.resume(); }
+  bool Done() const { return handle_.done(); }
+  T Result() { return handle_.promise().Result(); }
+
+  bool await_ready() const noexcept { return false; }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+    handle_.promise().continuation_ = awaiter;
+    return handle_;
+  }
+  T await_resume() { return handle_.promise().Result(); }
+
+ private:
+  Handle handle_;
+};
+
+namespace detail {
+
+template <typename T>
+inline Task<T> TaskPromise<T>::get_return_object() {
+  return Task<T>(Task<T>::Handle::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+  return Task<void>(Task<void>::Handle::from_promise(*this));
+}
+
+} // detail
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_COROUTINE_H_
@@ -0,0 +1,86 @@
+//
+//  coroutine_pacing.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_COROUTINE_PACING_H_
+#define YCSB_C_COROUTINE_PACING_H_
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "rate_limit.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Coroutines of a client thread waiting for rate limiters. A coroutine
+/// awaits Until(due) instead of sleeping, so the thread keeps polling the
+/// operations of the others, and the thread resumes it once due has passed.
+///
+class CoroutinePacing {
+ public:
+  struct Awaiter {
+    CoroutinePacing *pacing;
+    uint64_t due;
+
+    bool await_ready() const noexcept { return Now() >= due; }
+    void await_suspend(std::coroutine_handle<> handle) { pacing->waiters_.emplace(due, handle); }
+    void await_resume() const noexcept {}
+  };
+
+  ///
+  /// Suspends the calling coroutine until due, in nanoseconds of the steady clock.
+  /// The thread spins for the last spin_ns nanoseconds before it, as the limiter would.
+  ///
+  Awaiter Until(uint64_t due, int64_t spin_ns) {
+    spin_ns_ = std::max(spin_ns_, spin_ns);
+    return Awaiter{this, due};
+  }
+
+  ///
+  /// Resumes the coroutines that are due.
+  ///
+  void ResumeDue() {
+    uint64_t now = Now();
+    while (!waiters_.empty() && waiters_.top().first <= now) {
+      std::coroutine_handle<> handle = waiters_.top().second;
+      waiters_.pop();
+      handle.resume();
+    }
+  }
+
+  size_t Waiting() const { return waiters_.size(); }
+
+  ///
+  /// Sleeps until the first waiting coroutine is due.
+  ///
+  void SleepUntilDue() const {
+    SleepUntil(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(waiters_.top().first)), spin_ns_);
+  }
+
+ private:
+  using Waiter = std::pair<uint64_t, std::coroutine_handle<>>;
+
+  static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  std::priority_queue<Waiter, std::vector<Waiter>, std::greater<Waiter>> waiters_;
+  int64_t spin_ns_ = 0;
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_COROUTINE_PACING_H_
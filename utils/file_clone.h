@@ -0,0 +1,87 @@
+//
+//  file_clone.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_FILE_CLONE_H_
+#define YCSB_C_FILE_CLONE_H_
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Copies file src to the new file dst. The copy shares the data blocks of src
+/// (reflink) where the filesystem supports it, which takes constant time, and
+/// is a regular copy otherwise. Reflinks are only tried on Linux.
+///
+inline void CloneFile(const std::string &src, const std::string &dst) {
+#ifdef __linux__
+  int in = open(src.c_str(), O_RDONLY);
+  if (in < 0) {
+    throw Exception("failed to open: " + src);
+  }
+  int out = open(dst.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+  if (out < 0) {
+    close(in);
+    throw Exception("failed to create: " + dst);
+  }
+  bool cloned = ioctl(out, FICLONE, in) == 0;
+  close(in);
+  close(out);
+  if (cloned) {
+    return;
+  }
+#endif
+  std::error_code ec;
+  std::filesystem::copy_file(src, dst, std::filesystem::copy_options::overwrite_existing, ec);
+  if (ec) {
+    throw Exception("failed to copy " + src + " to " + dst + ": " + ec.message());
+  }
+}
+
+///
+/// Recreates directory dst as a copy of directory src, cloning each file.
+/// Anything at dst before is removed.
+///
+inline void CloneTree(const std::string &src, const std::string &dst) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  if (!fs::is_directory(src, ec)) {
+    throw Exception("not a directory: " + src);
+  }
+  fs::remove_all(dst, ec);
+  if (ec || !fs::create_directories(dst, ec)) {
+    throw Exception("failed to create: " + dst);
+  }
+  for (fs::recursive_directory_iterator it(src, ec), end; !ec && it != end; it.increment(ec)) {
+    const std::string target = (fs::path(dst) / fs::relative(it->path(), src)).string();
+    if (it->is_directory()) {
+      fs::create_directory(target, ec);
+    } else if (it->is_regular_file()) {
+      CloneFile(it->path().string(), target);
+    }
+  }
+  if (ec) {
+    throw Exception("failed to copy " + src + " to " + dst + ": " + ec.message());
+  }
+}
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_FILE_CLONE_H_
@@ -0,0 +1,78 @@
+//
+//  huge_pages.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_HUGE_PAGES_H_
+#define YCSB_C_HUGE_PAGES_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Anonymous memory backed by transparent huge pages where the kernel allows,
+/// so scanning a large buffer does not thrash the TLB. Pages are only allocated
+/// when first written. Elsewhere the buffer is a plain allocation.
+///
+class HugePageBuffer {
+ public:
+  static constexpr size_t kHugePageSize = 2 << 20;
+
+  explicit HugePageBuffer(size_t bytes) : size_((bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize) {
+    if (size_ == 0) {
+      return;
+    }
+#ifdef __linux__
+    void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) {
+      throw Exception("failed to map " + std::to_string(size_) + " bytes");
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(data, size_, MADV_HUGEPAGE);
+#endif
+#else
+    void *data = std::malloc(size_);
+    if (data == nullptr) {
+      throw Exception("failed to allocate " + std::to_string(size_) + " bytes");
+    }
+#endif
+    data_ = static_cast<char *>(data);
+  }
+
+  ~HugePageBuffer() {
+    if (data_ != nullptr) {
+#ifdef __linux__
+      munmap(data_, size_);
+#else
+      std::free(data_);
+#endif
+    }
+  }
+
+  HugePageBuffer(const HugePageBuffer &) = delete;
+  HugePageBuffer &operator=(const HugePageBuffer &) = delete;
+
+  char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  char *data_ = nullptr;
+  size_t size_;
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_HUGE_PAGES_H_
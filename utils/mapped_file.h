@@ -0,0 +1,96 @@
+//
+//  mapped_file.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_MAPPED_FILE_H_
+#define YCSB_C_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "utils.h"
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Read-only memory mapping of a whole file. Pages are faulted in as they are
+/// read and can be dropped by the kernel again, so files larger than memory
+/// can be streamed. Elsewhere the file is read into memory.
+///
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) {
+#ifdef __linux__
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw Exception("failed to open: " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw Exception("failed to stat: " + path);
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+      void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        throw Exception("failed to map: " + path);
+      }
+      madvise(data, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char *>(data);
+    }
+    close(fd);
+#else
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+      throw Exception("failed to open: " + path);
+    }
+    std::ostringstream contents;
+    contents << input.rdbuf();
+    contents_ = contents.str();
+    data_ = contents_.data();
+    size_ = contents_.size();
+#endif
+  }
+
+  ~MappedFile() {
+#ifdef __linux__
+    if (data_ != nullptr) {
+      munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *begin() const { return data_; }
+  const char *end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+#ifndef __linux__
+  std::string contents_;
+#endif
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_MAPPED_FILE_H_
@@ -0,0 +1,152 @@
+//
+//  op_budget.h
+//  YCSB-cpp
+//
+
+#ifndef YCSB_C_OP_BUDGET_H_
+#define YCSB_C_OP_BUDGET_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ycsbc {
+
+namespace utils {
+
+///
+/// Operation budget shared by the client threads of a phase.
+/// Threads claim operations in chunks until the operation count or the
+/// deadline runs out, so a slow thread does not stretch the run.
+/// Also tracks the window in which all threads were running.
+///
+class OpBudget {
+ public:
+  static constexpr int64_t kUnlimited = std::numeric_limits<int64_t>::max();
+
+  OpBudget(int num_threads, int64_t max_ops, double max_seconds, int64_t chunk)
+      : num_threads_(num_threads), max_ops_(max_ops), chunk_(std::max<int64_t>(chunk, 1)),
+        max_nanos_(max_seconds > 0 ? static_cast<int64_t>(max_seconds * 1e9) : 0), done_(num_threads) {}
+
+  ///
+  /// Starts the time limit, if any. Must happen before threads claim operations.
+  ///
+  void Start() {
+    start_ = NowNanos();
+    deadline_ = max_nanos_ != 0 ? start_ + max_nanos_ : 0;
+  }
+
+  ///
+  /// Claims up to a chunk of operations. Returns 0 when the budget is exhausted.
+  ///
+  int64_t Claim() {
+    if (Expired() || claimed_.load(std::memory_order_relaxed) >= max_ops_) {
+      return 0;
+    }
+    int64_t prev = claimed_.fetch_add(chunk_, std::memory_order_relaxed);
+    if (prev >= max_ops_) {
+      return 0;
+    }
+    return std::min(chunk_, max_ops_ - prev);
+  }
+
+  bool Expired() const {
+    return stopped_.load(std::memory_order_relaxed) || (deadline_ != 0 && NowNanos() >= deadline_);
+  }
+
+  ///
+  /// Ends the budget early, threads stop before their next operation.
+  ///
+  void Stop() { stopped_.store(true, std::memory_order_relaxed); }
+
+  ///
+  /// Operations completed so far by all threads.
+  ///
+  int64_t DoneOps() const {
+    int64_t sum = 0;
+    for (auto &slot : done_) {
+      sum += slot.ops.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  ///
+  /// Registers the calling thread as running and returns its slot.
+  ///
+  int Join() {
+    int slot = joined_.fetch_add(1, std::memory_order_relaxed);
+    if (slot + 1 == num_threads_) {
+      window_start_ops_ = DoneOps();
+      window_start_ = NowNanos();
+      all_joined_.store(true, std::memory_order_release);
+    }
+    return slot;
+  }
+
+  ///
+  /// Publishes the number of operations the thread in slot has completed.
+  ///
+  void Complete(int slot, int64_t ops) { done_[slot].ops.store(ops, std::memory_order_relaxed); }
+
+  void Leave() {
+    int left = left_.fetch_add(1, std::memory_order_acq_rel);
+    if (left == 0 && all_joined_.load(std::memory_order_acquire)) {
+      window_end_ = NowNanos();
+      window_end_ops_ = DoneOps();
+      has_window_ = true;
+    }
+    if (left + 1 == num_threads_) {
+      end_ = NowNanos();
+    }
+  }
+
+  ///
+  /// Time from Start until the last thread left, valid after all threads left.
+  ///
+  double ElapsedSeconds() const { return (end_ - start_) / 1e9; }
+
+  ///
+  /// Window in which all threads were running, valid after all threads left.
+  ///
+  bool HasWindow() const { return has_window_ && window_end_ > window_start_; }
+  double WindowSeconds() const { return (window_end_ - window_start_) / 1e9; }
+  int64_t WindowOps() const { return window_end_ops_ - window_start_ops_; }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<int64_t> ops{0};
+  };
+
+  static int64_t NowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  const int num_threads_;
+  const int64_t max_ops_;
+  const int64_t chunk_;
+  const int64_t max_nanos_;
+  int64_t start_ = 0;
+  int64_t end_ = 0;
+  int64_t deadline_ = 0;
+  alignas(64) std::atomic<int64_t> claimed_{0};
+  std::vector<Slot> done_;
+  std::atomic<bool> stopped_{false};
+  std::atomic<int> joined_{0};
+  std::atomic<int> left_{0};
+  std::atomic<bool> all_joined_{false};
+  int64_t window_start_ = 0;
+  int64_t window_start_ops_ = 0;
+  int64_t window_end_ = 0;
+  int64_t window_end_ops_ = 0;
+  bool has_window_ = false;
+};
+
+} // utils
+
+} // ycsbc
+
+#endif // YCSB_C_OP_BUDGET_H_
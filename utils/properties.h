@@ -27,6 +27,10 @@ class Properties {
   const std::string &operator[](const std::string &key) const;
   void SetProperty(const std::string &key, const std::string &value);
   bool ContainsKey(const std::string &key) const;
+  ///
+  /// Returns a copy in which each property "<prefix><key>" overrides "<key>".
+  ///
+  Properties Scoped(const std::string &prefix) const;
   void Load(std::ifstream &input);
  private:
   std::map<std::string, std::string> properties_;
@@ -54,6 +58,15 @@ inline bool Properties::ContainsKey(const std::string &key) const {
   return properties_.find(key) != properties_.end();
 }
 
+inline Properties Properties::Scoped(const std::string &prefix) const {
+  Properties scoped = *this;
+  for (auto it = properties_.lower_bound(prefix);
+       it != properties_.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+    scoped.SetProperty(it->first.substr(prefix.size()), it->second);
+  }
+  return scoped;
+}
+
 inline void Properties::Load(std::ifstream &input) {
   if (!input.is_open()) {
     throw Exception("File not open!");
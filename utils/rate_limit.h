@@ -9,68 +9,289 @@
 #define YCSB_C_RATE_LIMIT_H_
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <cstdio>
-#include <mutex>
-#include <ratio>
+#include <cstdint>
+#include <memory>
 #include <thread>
 
+#include "arrival_pattern.h"
+
 namespace ycsbc {
 
 namespace utils {
 
-// Token bucket rate limiter for single client
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+// Waits until deadline, sleeping until spin_ns before it and spinning for the rest,
+// since sleeping alone oversleeps by tens of microseconds
+inline void SleepUntil(std::chrono::steady_clock::time_point deadline, int64_t spin_ns) {
+  auto remaining = deadline - std::chrono::steady_clock::now();
+  if (remaining > std::chrono::nanoseconds(spin_ns)) {
+    std::this_thread::sleep_for(remaining - std::chrono::nanoseconds(spin_ns));
+  }
+  while (std::chrono::steady_clock::now() < deadline) {
+    CpuRelax();
+  }
+}
+
+// Token bucket rate limiter shared by all client threads of a phase.
+// The bucket is kept as the time at which it is empty, so acquiring tokens is a
+// single compare-and-swap on a timestamp instead of a mutex. Waits use SleepUntil.
 class RateLimiter {
  public:
-  RateLimiter(int64_t r, int64_t b) : r_(r * TOKEN_PRECISION), b_(b * TOKEN_PRECISION), tokens_(0), last_(Clock::now()) {}
+  // r operations per second (unlimited if <= 0), bursts of up to b operations,
+  // spin for the last spin_ns nanoseconds of every wait
+  RateLimiter(int64_t r, int64_t b, int64_t spin_ns = 100000)
+      : origin_(Clock::now()), spin_(spin_ns * PS_PER_NS), interval_(Interval(r)),
+        burst_(std::max<int64_t>(b, 1)) {}
 
-  inline void Consume(int64_t n) {
-    std::unique_lock<std::mutex> lock(mutex_);
+  // Shapes the gaps between operations, e.g. Poisson or bursty arrivals around the rate.
+  // Must be set before the limiter is used.
+  void SetPattern(ArrivalPattern *pattern) { pattern_.reset(pattern); }
 
-    if (r_ <= 0) {
+  inline void Consume(int64_t n) {
+    int64_t interval = interval_.load(std::memory_order_relaxed);
+    if (interval == 0) {
       return;
     }
 
-    // refill tokens
-    auto now = Clock::now();
-    auto diff = std::chrono::duration_cast<Duration>(now - last_);
-    tokens_ = std::min(b_, tokens_ + diff.count() * r_ / 1000000000);
-    last_ = now;
+    int64_t now = Now();
+    int64_t next;
+    TakeTokens(n, interval, now, false, &next);
+    // wait until the missing tokens are refilled
+    Record(next > now ? WaitUntil(next) : 0);
+  }
 
-    // check tokens
-    tokens_ -= n * TOKEN_PRECISION;
+  // Takes n tokens without waiting and returns the time, in nanoseconds of the steady
+  // clock, at which they are refilled. The caller waits until then itself and calls
+  // Released, e.g. a coroutine that must not block its thread.
+  inline uint64_t Reserve(int64_t n) {
+    int64_t now = Now();
+    int64_t interval = interval_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+      return ToSteadyNanos(now);
+    }
+    int64_t next;
+    TakeTokens(n, interval, now, false, &next);
+    return ToSteadyNanos(std::max(next, now));
+  }
 
-    // sleep
-    if (tokens_ < 0) {
-      lock.unlock();
-      int64_t wait_time = -tokens_ * 1000000000 / r_;
-      std::this_thread::sleep_for(std::chrono::nanoseconds(wait_time));
+  // Takes n tokens only if they are available without waiting
+  inline bool TryConsume(int64_t n) {
+    int64_t interval = interval_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+      return true;
+    }
+    int64_t next;
+    if (!TakeTokens(n, interval, Now(), true, &next)) {
+      return false;
     }
+    Record(0);
+    return true;
   }
 
   inline void SetRate(int64_t r) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t interval = Interval(r);
+    if (interval_.exchange(interval, std::memory_order_relaxed) == 0 && interval != 0) {
+      // leaving unlimited mode: start with an empty bucket and a new open-loop schedule
+      empty_.store(Now(), std::memory_order_relaxed);
+      schedule_.store(UNSCHEDULED, std::memory_order_relaxed);
+    }
+  }
+
+  // Open-loop pacing: operations are issued on a fixed schedule of one every 1/r
+  // seconds, independent of how long previous operations took. Sleeps until the
+  // next slot if it is in the future and returns its intended start time in
+  // nanoseconds of the steady clock. A stalled client falls behind the schedule
+  // instead of silently lowering the offered load.
+  inline uint64_t NextIntendedStart() {
+    int64_t now = Now();
+    int64_t interval = interval_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+      return ToSteadyNanos(now);
+    }
+    int64_t start;
+    ClaimSlot(interval, now, false, &start);
+    Record(start > now ? WaitUntil(start) : now - start);
+    return ToSteadyNanos(start);
+  }
+
+  // Claims the next open-loop slot without waiting and returns its intended start time,
+  // which may be in the future; the caller waits until then and calls Released
+  inline uint64_t ReserveNextIntendedStart() {
+    int64_t now = Now();
+    int64_t interval = interval_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+      return ToSteadyNanos(now);
+    }
+    int64_t start;
+    ClaimSlot(interval, now, false, &start);
+    return ToSteadyNanos(start);
+  }
+
+  // Records the pacing error of an operation reserved for due (steady clock nanoseconds)
+  // and released now
+  inline void Released(uint64_t due) {
+    if (interval_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    int64_t late = static_cast<int64_t>(SteadyNanos() - due);
+    Record(std::max<int64_t>(late, 0) * PS_PER_NS);
+  }
+
+  int64_t SpinNanos() const { return spin_ / PS_PER_NS; }
+
+  // Claims the next open-loop slot only if it is due, storing its intended start time
+  inline bool TryNextIntendedStart(uint64_t *intended_start) {
+    int64_t now = Now();
+    int64_t interval = interval_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+      *intended_start = ToSteadyNanos(now);
+      return true;
+    }
+    int64_t start;
+    if (!ClaimSlot(interval, now, true, &start)) {
+      return false;
+    }
+    Record(now - start);
+    *intended_start = ToSteadyNanos(start);
+    return true;
+  }
 
-    // refill tokens
-    auto now = Clock::now();
-    auto diff = std::chrono::duration_cast<Duration>(now - last_);
-    tokens_ = std::min(b_, tokens_ + diff.count() * r_ * TOKEN_PRECISION / 1000000000);
-    last_ = now;
+  // Pacing error, the delay between the time an operation was due and the time it
+  // was released, over all paced operations
+  struct PacingError {
+    int64_t ops = 0;
+    double mean_us = 0;
+    double max_us = 0;
+  };
 
-    // set rate
-    r_ = r * TOKEN_PRECISION;
+  PacingError GetPacingError() const {
+    PacingError error;
+    int64_t sum = 0, max = 0;
+    for (const Stripe &stripe : stripes_) {
+      error.ops += stripe.ops.load(std::memory_order_relaxed);
+      sum += stripe.late_sum.load(std::memory_order_relaxed);
+      max = std::max(max, stripe.late_max.load(std::memory_order_relaxed));
+    }
+    if (error.ops > 0) {
+      error.mean_us = static_cast<double>(sum) / error.ops / 1000;
+    }
+    error.max_us = max / 1000.0;
+    return error;
+  }
+
+  // Bucket size in operations, e.g. to keep bursts at one second worth of operations
+  // when the rate changes
+  void SetBurst(int64_t b) { burst_.store(std::max<int64_t>(b, 1), std::memory_order_relaxed); }
+
+  // Starts over with an empty bucket, a new open-loop schedule and no pacing error
+  void Reset() {
+    empty_.store(Now(), std::memory_order_relaxed);
+    schedule_.store(UNSCHEDULED, std::memory_order_relaxed);
+    for (Stripe &stripe : stripes_) {
+      stripe.ops.store(0, std::memory_order_relaxed);
+      stripe.late_sum.store(0, std::memory_order_relaxed);
+      stripe.late_max.store(0, std::memory_order_relaxed);
+    }
   }
 
  private:
   using Clock = std::chrono::steady_clock;
-  using Duration = std::chrono::nanoseconds;
-  static constexpr int64_t TOKEN_PRECISION = 10000;
-
-  std::mutex mutex_;
-  int64_t r_;
-  int64_t b_;
-  int64_t tokens_;
-  Clock::time_point last_;
+  // timestamps are picoseconds since origin_ so that intervals of fast rates stay exact
+  static constexpr int64_t PS_PER_NS = 1000;
+  static constexpr int64_t PS_PER_SEC = 1000000000000;
+  static constexpr int64_t UNSCHEDULED = INT64_MIN;
+  static constexpr int NUM_STRIPES = 64;
+
+  // pacing statistics are striped over threads to keep the hot path uncontended
+  struct alignas(64) Stripe {
+    std::atomic<int64_t> ops{0};
+    std::atomic<int64_t> late_sum{0};
+    std::atomic<int64_t> late_max{0};
+  };
+
+  static int64_t Interval(int64_t r) { return r > 0 ? std::max<int64_t>(PS_PER_SEC / r, 1) : 0; }
+
+  int64_t Gap(int64_t interval, int64_t now) const {
+    return pattern_ ? pattern_->Gap(interval, now) : interval;
+  }
+
+  int64_t Now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin_).count() * PS_PER_NS;
+  }
+
+  static uint64_t SteadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+  }
+
+  uint64_t ToSteadyNanos(int64_t t) const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(origin_.time_since_epoch()).count() +
+           t / PS_PER_NS;
+  }
+
+  // takes n tokens at now, the bucket holds at most burst_ tokens; stores the time at which
+  // they are refilled in *next, or takes nothing and returns false if only_if_due and that
+  // time is in the future
+  bool TakeTokens(int64_t n, int64_t interval, int64_t now, bool only_if_due, int64_t *next) {
+    int64_t gap = n * Gap(interval, now);
+    int64_t empty = empty_.load(std::memory_order_relaxed);
+    do {
+      *next = std::max(empty, now - burst_.load(std::memory_order_relaxed) * interval) + gap;
+      if (only_if_due && *next > now) {
+        return false;
+      }
+    } while (!empty_.compare_exchange_weak(empty, *next, std::memory_order_relaxed));
+    return true;
+  }
+
+  // claims the next open-loop slot and stores its start in *start, or claims nothing and
+  // returns false if only_if_due and the slot starts after now
+  bool ClaimSlot(int64_t interval, int64_t now, bool only_if_due, int64_t *start) {
+    int64_t gap = Gap(interval, now);
+    int64_t intended = schedule_.load(std::memory_order_relaxed);
+    do {
+      *start = intended == UNSCHEDULED ? now : intended;
+      if (only_if_due && *start > now) {
+        return false;
+      }
+    } while (!schedule_.compare_exchange_weak(intended, *start + gap, std::memory_order_relaxed));
+    return true;
+  }
+
+  // waits until deadline, returns how late the caller was released
+  int64_t WaitUntil(int64_t deadline) const {
+    SleepUntil(origin_ + std::chrono::nanoseconds((deadline + PS_PER_NS - 1) / PS_PER_NS), spin_ / PS_PER_NS);
+    return Now() - deadline;
+  }
+
+  void Record(int64_t late) {
+    static std::atomic<int> next_stripe{0};
+    thread_local int index = next_stripe.fetch_add(1, std::memory_order_relaxed) % NUM_STRIPES;
+    Stripe &stripe = stripes_[index];
+    late /= PS_PER_NS;
+    stripe.ops.fetch_add(1, std::memory_order_relaxed);
+    stripe.late_sum.fetch_add(late, std::memory_order_relaxed);
+    int64_t max = stripe.late_max.load(std::memory_order_relaxed);
+    while (late > max && !stripe.late_max.compare_exchange_weak(max, late, std::memory_order_relaxed)) {
+    }
+  }
+
+  const Clock::time_point origin_;
+  const int64_t spin_;
+  std::unique_ptr<ArrivalPattern> pattern_;
+  alignas(64) std::atomic<int64_t> interval_;
+  std::atomic<int64_t> burst_;
+  alignas(64) std::atomic<int64_t> empty_{0};
+  alignas(64) std::atomic<int64_t> schedule_{UNSCHEDULED};
+  Stripe stripes_[NUM_STRIPES];
 };
 
 } // utils
@@ -15,6 +15,7 @@
 
 #include "core/core_workload.h"
 #include "core/db_factory.h"
+#include "utils/file_clone.h"
 #include "utils/utils.h"
 
 #include "wiredtiger_db.h"
@@ -45,6 +46,9 @@ namespace {
   const std::string PROP_IN_MEMORY = WT_PREFIX ".in_memory";
   const std::string PROP_IN_MEMORY_DEFAULT = "false";
 
+  const std::string PROP_STATISTICS = WT_PREFIX ".statistics";
+  const std::string PROP_STATISTICS_DEFAULT = "none";
+
   const std::string PROP_LSM_MGR_MERGE = WT_PREFIX ".lsm_mgr.merge";
   const std::string PROP_LSM_MGR_MERGE_DEFAULT = "true";
 
@@ -80,6 +84,12 @@ namespace {
 
   const std::string PROP_BLK_MGR_BTREE_LEAF_PAGE_MAX = WT_PREFIX ".blk_mgr.btree.leaf_page_max";
   const std::string PROP_BLK_MGR_BTREE_LEAF_PAGE_MAX_DEFAULT = "32KB";
+
+  bool ReadStat(WT_CURSOR *cursor, int key, int64_t *value){
+    const char *desc, *pvalue;
+    cursor->set_key(cursor, key);
+    return cursor->search(cursor) == 0 && cursor->get_value(cursor, &desc, &pvalue, value) == 0;
+  }
 }
 
 namespace ycsbc {
@@ -98,6 +108,7 @@ void WTDB::Init(){
 
   if(format=="single"){
     method_read_ = &WTDB::ReadSingleEntry;
+    method_multiread_ = &WTDB::MultiReadSingleEntry;
     method_scan_ = &WTDB::ScanSingleEntry;
     method_update_ = &WTDB::UpdateSingleEntry;
     method_insert_ = &WTDB::InsertSingleEntry;
@@ -131,9 +142,11 @@ void WTDB::Init(){
       const std::string &cache_size = props.GetProperty(PROP_CACHE_SIZE, PROP_CACHE_SIZE_DEFAULT);
       const std::string &direct_io = props.GetProperty(PROP_DIRECT_IO, PROP_DIRECT_IO_DEFAULT);
       const std::string &in_memory = props.GetProperty(PROP_IN_MEMORY, PROP_IN_MEMORY_DEFAULT);
+      const std::string &statistics = props.GetProperty(PROP_STATISTICS, PROP_STATISTICS_DEFAULT);
       if(!cache_size.empty()) db_config += "cache_size="+ cache_size+ ",";
       if(!direct_io.empty())  db_config += "direct_io=" + direct_io + ",";
       if(!in_memory.empty())  db_config += "in_memory=" + in_memory + ",";
+      if(!statistics.empty()) db_config += "statistics=(" + statistics + "),";
     }
     { // 2.2 LSM Manager
       std::string lsm_config;
@@ -204,6 +217,26 @@ void WTDB::Cleanup(){
   error_check(conn_->close(conn_, NULL));
 }
 
+bool WTDB::GetCacheStats(uint64_t *hits, uint64_t *misses){
+  // sessions are single threaded, use a private one
+  WT_SESSION *session;
+  if(conn_ == nullptr || conn_->open_session(conn_, NULL, NULL, &session) != 0){
+    return false;
+  }
+  WT_CURSOR *cursor;
+  int64_t requested = 0, read = 0;
+  bool ok = session->open_cursor(session, "statistics:", NULL, NULL, &cursor) == 0 &&
+            ReadStat(cursor, WT_STAT_CONN_CACHE_PAGES_REQUESTED, &requested) &&
+            ReadStat(cursor, WT_STAT_CONN_CACHE_READ, &read);
+  session->close(session, NULL);
+  if(!ok){
+    return false;
+  }
+  *hits = requested > read ? requested - read : 0;
+  *misses = read;
+  return true;
+}
+
 DB::Status WTDB::ReadSingleEntry(const std::string &table, const std::string &key,
                                       const std::vector<std::string> *fields,
                                       std::vector<Field> &result) {
@@ -226,6 +259,34 @@ DB::Status WTDB::ReadSingleEntry(const std::string &table, const std::string &ke
   return kOK;
 }
 
+DB::Status WTDB::MultiReadSingleEntry(const std::string &table, const std::vector<std::string> &keys,
+                                      const std::vector<std::string> *fields,
+                                      std::vector<std::vector<Field>> &result) {
+  Status s = kOK;
+  WT_ITEM v;
+  int ret;
+  ResizeRows(result, keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    WT_ITEM k = {keys[i].data(), keys[i].size()};
+    cursor_->set_key(cursor_, &k);
+    ret = cursor_->search(cursor_);
+    if(ret==WT_NOTFOUND){
+      s = kNotFound;
+      continue;
+    } else if(ret != 0) {
+      throw utils::Exception(WT_PREFIX " search error");
+    }
+    error_check(cursor_->get_value(cursor_, &v));
+    if (fields != nullptr) {
+      DeserializeRowFilter(&result[i], (const char*)v.data, v.size, *fields);
+    } else {
+      DeserializeRow(&result[i], (const char*)v.data, v.size);
+    }
+  }
+  error_check(cursor_->reset(cursor_));
+  return s;
+}
+
 DB::Status WTDB::ScanSingleEntry(const std::string &table, const std::string &key, int len,
                                       const std::vector<std::string> *fields,
                                       std::vector<std::vector<Field>> &result) {
@@ -240,7 +301,7 @@ DB::Status WTDB::ScanSingleEntry(const std::string &table, const std::string &ke
   }
   for(int i=0; !ret && i<len; ++i){
     error_check(cursor_->get_value(cursor_, &v));
-    result.emplace_back(std::vector<Field>());
+    AppendRow(result);
     if (fields != nullptr) {
       DeserializeRowFilter(&result.back(), (const char*)v.data, v.size, *fields);
     } else {
@@ -306,6 +367,85 @@ DB::Status WTDB::InsertSingleEntry(const std::string &table, const std::string &
   // TODO: cursor reset?
   return kOK;
 }
+// A bulk cursor builds the pages of an empty table directly from sorted keys, but can only
+// be opened while no other cursor is open on the table, so it is used when this is the only
+// session. Otherwise each batch is inserted in one transaction.
+DB::Status WTDB::BulkInsert(const std::string &table, std::vector<Record> &records){
+  if(!bulk_checked_){
+    bulk_checked_ = true;
+    const std::lock_guard<std::mutex> lock(mu_);
+    if(ref_cnt_ == 1){
+      error_check(cursor_->close(cursor_));
+      cursor_ = nullptr;
+      if(session_->open_cursor(session_, "table:ycsbc", NULL, "bulk", &bulk_cursor_) != 0){
+        bulk_cursor_ = nullptr;
+        error_check(session_->open_cursor(session_, "table:ycsbc", NULL, "overwrite=true", &cursor_));
+      }
+    }
+  }
+  WT_CURSOR *cursor = bulk_cursor_ != nullptr ? bulk_cursor_ : cursor_;
+  if(bulk_cursor_ == nullptr){
+    error_check(session_->begin_transaction(session_, NULL));
+  }
+  std::string data;
+  for(Record &record : records){
+    WT_ITEM k = {record.key.data(), record.key.size()}, v;
+    cursor->set_key(cursor, &k);
+    data.clear();
+    SerializeRow(record.values, &data);
+    v.data = data.data();
+    v.size = data.size();
+    cursor->set_value(cursor, &v);
+    error_check(cursor->insert(cursor));
+  }
+  if(bulk_cursor_ == nullptr){
+    error_check(session_->commit_transaction(session_, NULL));
+  }
+  return kOK;
+}
+
+DB::Status WTDB::FinishBulkLoad(const std::string &table){
+  bulk_checked_ = false;
+  if(bulk_cursor_ == nullptr){
+    return kOK;
+  }
+  error_check(bulk_cursor_->close(bulk_cursor_));
+  bulk_cursor_ = nullptr;
+  error_check(session_->open_cursor(session_, "table:ycsbc", NULL, "overwrite=true", &cursor_));
+  return kOK;
+}
+
+// While a backup cursor is open WiredTiger keeps the files it lists consistent, so they are
+// cloned one by one.
+DB::Status WTDB::Snapshot(const std::string &dir){
+  int ret = mkdir(dir.c_str(), 0775);
+  if (ret) {
+    throw utils::Exception(std::string("Snapshot mkdir: ") + strerror(errno));
+  }
+  const std::string &home = props_->GetProperty(PROP_HOME, PROP_HOME_DEFAULT);
+  WT_CURSOR *backup;
+  error_check(session_->open_cursor(session_, "backup:", NULL, NULL, &backup));
+  while((ret = backup->next(backup)) == 0){
+    const char *file;
+    error_check(backup->get_key(backup, &file));
+    utils::CloneFile(home + "/" + file, dir + "/" + file);
+  }
+  error_check(backup->close(backup));
+  if(ret != WT_NOTFOUND){
+    throw utils::Exception(WT_PREFIX " backup cursor error");
+  }
+  return kOK;
+}
+
+DB::Status WTDB::Restore(const std::string &dir){
+  const std::string &home = props_->GetProperty(PROP_HOME, PROP_HOME_DEFAULT);
+  if(home.empty()){
+    throw utils::Exception(WT_PREFIX " home is missing");
+  }
+  utils::CloneTree(dir, home);
+  return kOK;
+}
+
 DB::Status WTDB::DeleteSingleEntry(const std::string &table, const std::string &key){
   WT_ITEM k = {key.data(), key.size()};
   cursor_->set_key(cursor_, &k);
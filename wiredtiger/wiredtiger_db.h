@@ -29,6 +29,11 @@ class WTDB : public DB {
     return (this->*(method_read_))(table, key, fields, result);
   }
 
+  Status MultiRead(const std::string &table, const std::vector<std::string> &keys,
+                   const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
+    return (this->*(method_multiread_))(table, keys, fields, result);
+  }
+
   Status Scan(const std::string &table, const std::string &key, int len,
               const std::vector<std::string> *fields, std::vector<std::vector<Field>> &result) {
     return (this->*(method_scan_))(table, key, len, fields, result);
@@ -46,10 +51,23 @@ class WTDB : public DB {
     return (this->*(method_delete_))(table, key);
   }
 
+  Status BulkInsert(const std::string &table, std::vector<Record> &records);
+
+  Status FinishBulkLoad(const std::string &table);
+
+  Status Snapshot(const std::string &dir);
+
+  Status Restore(const std::string &dir);
+
+  bool GetCacheStats(uint64_t *hits, uint64_t *misses);
+
  private:
 
   Status ReadSingleEntry(const std::string &table, const std::string &key,
                          const std::vector<std::string> *fields, std::vector<Field> &result);
+  Status MultiReadSingleEntry(const std::string &table, const std::vector<std::string> &keys,
+                              const std::vector<std::string> *fields,
+                              std::vector<std::vector<Field>> &result);
   Status ScanSingleEntry(const std::string &table, const std::string &key, int len,
                          const std::vector<std::string> *fields,
                          std::vector<std::vector<Field>> &result);
@@ -65,6 +83,9 @@ class WTDB : public DB {
 
   Status (WTDB::*method_read_)(const std::string &, const std:: string &,
                                     const std::vector<std::string> *, std::vector<Field> &);
+  Status (WTDB::*method_multiread_)(const std::string &, const std::vector<std::string> &,
+                                    const std::vector<std::string> *,
+                                    std::vector<std::vector<Field>> &);
   Status (WTDB::*method_scan_)(const std::string &, const std::string &, int,
                                     const std::vector<std::string> *,
                                     std::vector<std::vector<Field>> &);
@@ -79,6 +100,9 @@ class WTDB : public DB {
   static WT_CONNECTION *conn_;
   WT_SESSION *session_{nullptr};
   WT_CURSOR *cursor_{nullptr};
+  // bulk cursor of a bulk load, nullptr if the table could not be bulk loaded
+  WT_CURSOR *bulk_cursor_{nullptr};
+  bool bulk_checked_{false};
 
   static int ref_cnt_;
   static std::mutex mu_;